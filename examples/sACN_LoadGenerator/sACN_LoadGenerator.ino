@@ -0,0 +1,46 @@
+// Example for a priority takeover and malformed packets with a load generator,
+// with an EthernetUDP instead of the virtual socket it stresses a real receiver
+
+#include "sACN.h"
+#include "sACNVirtual.h"
+#include "sACNLoadGenerator.h"
+
+VirtualNetwork network;
+VirtualUDP sacn1(network, IPAddress(10, 0, 0, 1));
+VirtualUDP sacn2(network, IPAddress(10, 0, 0, 2));
+LoadGenerator load(sacn1, 1, 1, 2); // universe 1 with 2 sources
+Receiver recv1(sacn2);
+
+void newSource() {
+	Serial.print("new source with priority ");
+	Serial.println(recv1.priority());
+	}
+
+void setup() {
+	Serial.begin(9600);
+	delay(2000);
+	network.clock(); // the library runs on the virtual clock now
+	recv1.callbackSource(newSource);
+	recv1.begin(1);
+	load.priority(100, 50); // source 1 priority 100, source 2 priority 150
+	load.change(500); // payload changes on every 2nd packet
+	load.malformed(20); // 2 % malformed packets of all reject branches
+	load.begin(44);
+	Serial.println("sACN start");
+	for (uint16_t t = 0; t < 10000; t++) {
+		network.advance(1);
+		load.update();
+		recv1.drain();
+		}
+	Serial.print("sent: ");
+	Serial.print(load.sent());
+	Serial.print(" malformed: ");
+	Serial.print(load.malformed());
+	Serial.print(" valid: ");
+	Serial.print(recv1.packets());
+	Serial.print(" selected priority: ");
+	Serial.println(recv1.priority());
+	}
+
+void loop() {
+	}
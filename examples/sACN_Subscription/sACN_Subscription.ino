@@ -0,0 +1,49 @@
+// Example for receiving a range of universes with a small socket pool
+
+#include "Ethernet.h"
+#include "sACN.h"
+#include "sACNSubscription.h"
+
+uint8_t mac[] = {0x90, 0xA2, 0xDA, 0x10, 0x14, 0x48}; // MAC Adress of your device
+IPAddress ip(10, 101, 1, 201); // IP address of your device
+IPAddress dns(10, 101, 1, 100); // DNS address of your device
+IPAddress gateway(10, 101, 1, 100); // Gateway address of your device
+IPAddress subnet(255, 255, 0, 0); // Subnet mask of your device
+
+EthernetUDP sacn1;
+EthernetUDP sacn2;
+EthernetUDP sacn3;
+EthernetUDP sacn4;
+UDP *sockets[] = {&sacn1, &sacn2, &sacn3, &sacn4};
+
+#define UNIVERSES 8
+Subscription subscription(sockets, 4, UNIVERSES);
+Receiver recv[UNIVERSES]; // receivers without an own socket
+
+void timeOut() {
+	Serial.println("Timeout!");
+	}
+
+void setup() {
+	Serial.begin(9600);
+	delay(2000);
+	Ethernet.begin(mac, ip, dns, gateway, subnet);
+	for (uint8_t i = 0; i < UNIVERSES; i++) {
+		recv[i].callbackTimeout(timeOut);
+		}
+	subscription.add(recv, 1, UNIVERSES); // universe 1 ... 8
+	subscription.begin();
+	Serial.println("sACN start");
+	}
+
+void loop() {
+	subscription.update();
+	static uint32_t timestamp;
+	if (millis() - timestamp > 1000) {
+		timestamp = millis();
+		Serial.print("joined groups: ");
+		Serial.print(subscription.joined());
+		Serial.print(" DMX Slot 1 universe 1: ");
+		Serial.println(recv[0].dmx(1));
+		}
+	}
@@ -0,0 +1,63 @@
+// Example for testing a receiver on a virtual network without hardware
+
+#include "sACN.h"
+#include "sACNVirtual.h"
+
+VirtualNetwork network; // packets in flight and the virtual clock
+VirtualUDP sacn1(network, IPAddress(10, 0, 0, 1));
+VirtualUDP sacn2(network, IPAddress(10, 0, 0, 2));
+Source send1(sacn1);
+Receiver recv1(sacn2);
+
+uint16_t timeouts;
+
+void timeOut() {
+	timeouts++;
+	}
+
+// 44 fps for a time in ms
+void stream(uint16_t time) {
+	for (uint16_t t = 0; t < time; t += 23) {
+		send1.dmx(1, send1.dmx()[0] + 1);
+		send1.send();
+		network.advance(23);
+		recv1.drain();
+		}
+	}
+
+void setup() {
+	Serial.begin(9600);
+	delay(2000);
+	network.clock(); // the library runs on the virtual clock now
+	recv1.callbackTimeout(timeOut);
+	recv1.begin(1);
+	send1.begin(1);
+	Serial.println("sACN start");
+
+	// sequence window, duplicated and late packets are rejected
+	network.duplicate(50); // 5 %
+	network.reorder(50, 30); // 5 % are held back for 30 ms
+	network.delay(2, 3); // 2 ms latency, 3 ms jitter
+	stream(23000);
+	Serial.print("sent: ");
+	Serial.print(network.sent());
+	Serial.print(" duplicated: ");
+	Serial.print(network.duplicated());
+	Serial.print(" reordered: ");
+	Serial.print(network.reordered());
+	Serial.print(" valid: ");
+	Serial.println(recv1.packets());
+
+	// data loss, the receiver times out once
+	network.loss(1000);
+	stream(3000);
+	network.loss(0);
+	stream(1000);
+	Serial.print("timeouts: ");
+	Serial.print(timeouts);
+	Serial.print(" source: ");
+	Serial.println(recv1.sources() ? "active" : "lost");
+	}
+
+void loop() {
+	}
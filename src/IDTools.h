@@ -16,6 +16,10 @@
  * To initialise the pseudo random generators add an usefull input like AnalogIn(x)
  * At least you should use hardware chips with included serial and mac address like 
  * AT24MAC402/AT24MAC602 from microchip
+ * For many CIDs there are batch functions with a counter based generator and
+ * name based UUIDs (version 5, SHA-1), they don't touch rand() and write
+ * into buffers of the caller, the functions returning a pointer use a static
+ * buffer and are not reentrant.
 */
 
 #ifndef ID_TOOLS_H
@@ -29,7 +33,7 @@
  * @param uuid 
  * @param srnd start number for random function
  */
-void generateUUID(uint8_t uuid[], unsigned int srnd) {
+inline void generateUUID(uint8_t uuid[], unsigned int srnd) {
 	srand(srnd);
 	for (uint8_t i = 0; i < 16; i++) {
 		uuid[i] = rand() %256;
@@ -44,7 +48,7 @@ void generateUUID(uint8_t uuid[], unsigned int srnd) {
  * @param srnd start number for random function
  * @return uint8_t* uuid
  */
-uint8_t* generateUUID(unsigned int srnd) {
+inline uint8_t* generateUUID(unsigned int srnd) {
 	static uint8_t uuid[16];
 	srand(srnd);
 	for (uint8_t i = 0; i < 16; i++) {
@@ -60,11 +64,11 @@ uint8_t* generateUUID(unsigned int srnd) {
  * @brief verify if UUID is RFC9562 conform
  * 
  * @param uuid 
- * @return true if variant and version ok
+ * @return true if variant and version 4 (random) or 5 (name based) ok
  * @return false 
  */
-bool verifyUUID(uint8_t uuid[]) {
-	if (uuid[6] >> 4 == 0x04 && uuid[8] >> 6 == 0x02) {
+inline bool verifyUUID(uint8_t uuid[]) {
+	if ((uuid[6] >> 4 == 0x04 || uuid[6] >> 4 == 0x05) && uuid[8] >> 6 == 0x02) {
 		return true;
 		}
 	else {
@@ -72,16 +76,244 @@ bool verifyUUID(uint8_t uuid[]) {
 		}
 	}
 
+static const char UUID_HEX[] = "0123456789ABCDEF";
+
+/**
+ * @brief converts the UUID to a string without sprintf()
+ * 
+ * @param uuid 
+ * @param text buffer for 37 characters
+ */
+inline void formatUUID(const uint8_t uuid[], char text[]) {
+	char *out = text;
+	for (uint8_t i = 0; i < 16; i++) {
+		if (i == 4 || i == 6 || i == 8 || i == 10) *out++ = '-';
+		*out++ = UUID_HEX[uuid[i] >> 4];
+		*out++ = UUID_HEX[uuid[i] & 0x0F];
+		}
+	*out = 0;
+	}
+
+/**
+ * @brief converts a string to a UUID, the hyphens are optional
+ * 
+ * @param text UUID string
+ * @param uuid 
+ * @return true if the string has 32 hex digits
+ * @return false on error, the uuid is unchanged
+ */
+inline bool parseUUID(const char text[], uint8_t uuid[]) {
+	uint8_t value[16];
+	uint8_t digits = 0;
+	for (const char *in = text; *in != 0; in++) {
+		char c = *in;
+		uint8_t nibble;
+		if (c >= '0' && c <= '9') nibble = c - '0';
+		else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+		else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+		else if (c == '-') continue;
+		else return false;
+		if (digits >= 32) return false;
+		if (digits & 1) value[digits >> 1] |= nibble;
+		else value[digits >> 1] = nibble << 4;
+		digits++;
+		}
+	if (digits != 32) return false;
+	memcpy(uuid, value, 16);
+	return true;
+	}
+
+/**
+ * @brief counter based random generator, every counter gives a new number without a state
+ * 
+ * @param seed key of the sequence
+ * @param counter position in the sequence
+ * @return uint64_t random number
+ */
+inline uint64_t uuidRandom(uint64_t seed, uint64_t counter) {
+	uint64_t x = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+	}
+
+/**
+ * @brief mix a device unique value, e.g. the MAC address, with a random start number,
+ * so two devices with the same start number at boot get different UUIDs
+ * 
+ * @param data device unique value
+ * @param size size of the value
+ * @param srnd random start number
+ * @return uint64_t seed for generateUUIDs()
+ */
+inline uint64_t uuidSeed(const uint8_t data[], uint8_t size, uint32_t srnd) {
+	uint64_t seed = uuidRandom(srnd, 0);
+	for (uint8_t i = 0; i < size; i++) {
+		seed = uuidRandom(seed, data[i]);
+		}
+	return seed;
+	}
+
+/**
+ * @brief generate random UUIDs with a counter based generator, rand() is not used
+ * 
+ * @param uuids array for count UUIDs
+ * @param count number of UUIDs
+ * @param seed key of the sequence, e.g. from uuidSeed()
+ * @param counter position in the sequence
+ * @return uint64_t counter for the next call
+ */
+inline uint64_t generateUUIDs(uint8_t uuids[][16], uint16_t count, uint64_t seed, uint64_t counter = 0) {
+	for (uint16_t n = 0; n < count; n++, counter++) {
+		uint64_t high = uuidRandom(seed, counter * 2);
+		uint64_t low = uuidRandom(seed, counter * 2 + 1);
+		for (uint8_t i = 0; i < 8; i++) {
+			uuids[n][i] = high >> (56 - i * 8);
+			uuids[n][i + 8] = low >> (56 - i * 8);
+			}
+		uuids[n][6] = 0x40 | (0x0F & uuids[n][6]); // version 4 / random based
+		uuids[n][8] = 0x80 | (0x3F & uuids[n][8]); // variant RFC4122
+		}
+	return counter;
+	}
+
+/**
+ * @brief SHA-1 state for name based UUIDs
+ * 
+ */
+struct UUIDHash {
+	uint32_t state[5];
+	uint8_t block[64];
+	uint8_t used;
+	uint32_t length;
+	};
+
+inline void uuidHashBlock(UUIDHash &hash) {
+	uint32_t w[16];
+	for (uint8_t i = 0; i < 16; i++) {
+		w[i] = ((uint32_t)hash.block[i * 4] << 24) | ((uint32_t)hash.block[i * 4 + 1] << 16) | ((uint32_t)hash.block[i * 4 + 2] << 8) | hash.block[i * 4 + 3];
+		}
+	uint32_t a = hash.state[0], b = hash.state[1], c = hash.state[2], d = hash.state[3], e = hash.state[4];
+	for (uint8_t i = 0; i < 80; i++) {
+		if (i >= 16) {
+			uint32_t x = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15];
+			w[i & 15] = (x << 1) | (x >> 31);
+			}
+		uint32_t f, k;
+		if (i < 20) {f = (b & c) | (~b & d); k = 0x5A827999;}
+		else if (i < 40) {f = b ^ c ^ d; k = 0x6ED9EBA1;}
+		else if (i < 60) {f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC;}
+		else {f = b ^ c ^ d; k = 0xCA62C1D6;}
+		uint32_t t = ((a << 5) | (a >> 27)) + f + e + k + w[i & 15];
+		e = d;
+		d = c;
+		c = (b << 30) | (b >> 2);
+		b = a;
+		a = t;
+		}
+	hash.state[0] += a;
+	hash.state[1] += b;
+	hash.state[2] += c;
+	hash.state[3] += d;
+	hash.state[4] += e;
+	hash.used = 0;
+	}
+
+inline void uuidHashInit(UUIDHash &hash) {
+	hash.state[0] = 0x67452301;
+	hash.state[1] = 0xEFCDAB89;
+	hash.state[2] = 0x98BADCFE;
+	hash.state[3] = 0x10325476;
+	hash.state[4] = 0xC3D2E1F0;
+	hash.used = 0;
+	hash.length = 0;
+	}
+
+inline void uuidHashWrite(UUIDHash &hash, const uint8_t data[], size_t size) {
+	hash.length += size;
+	while (size--) {
+		hash.block[hash.used++] = *data++;
+		if (hash.used == 64) uuidHashBlock(hash);
+		}
+	}
+
+/**
+ * @brief finish the hash and build a version 5 UUID from the first 16 bytes
+ * 
+ * @param hash 
+ * @param uuid 
+ */
+inline void uuidHashUUID(UUIDHash &hash, uint8_t uuid[]) {
+	uint64_t bits = (uint64_t)hash.length * 8;
+	hash.block[hash.used++] = 0x80;
+	if (hash.used > 56) {
+		while (hash.used < 64) hash.block[hash.used++] = 0;
+		uuidHashBlock(hash);
+		}
+	while (hash.used < 56) hash.block[hash.used++] = 0;
+	for (uint8_t i = 0; i < 8; i++) {
+		hash.block[56 + i] = bits >> (56 - i * 8);
+		}
+	uuidHashBlock(hash);
+	for (uint8_t i = 0; i < 16; i++) {
+		uuid[i] = hash.state[i >> 2] >> (24 - (i & 3) * 8);
+		}
+	uuid[6] = 0x50 | (0x0F & uuid[6]); // version 5 / name based
+	uuid[8] = 0x80 | (0x3F & uuid[8]); // variant RFC4122
+	}
+
+/**
+ * @brief generate a name based UUID (version 5), the same namespace and name give always the same UUID
+ * 
+ * @param uuid 
+ * @param ns namespace UUID, e.g. the CID of the device
+ * @param name name inside of the namespace
+ */
+inline void nameUUID(uint8_t uuid[], const uint8_t ns[], const char name[]) {
+	UUIDHash hash;
+	uuidHashInit(hash);
+	uuidHashWrite(hash, ns, 16);
+	uuidHashWrite(hash, (const uint8_t*)name, strlen(name));
+	uuidHashUUID(hash, uuid);
+	}
+
+/**
+ * @brief generate name based UUIDs (version 5) for the names name0, name1 ...,
+ * the hash of the namespace and the name is calculated once
+ * 
+ * @param uuids array for count UUIDs
+ * @param count number of UUIDs
+ * @param ns namespace UUID, e.g. the CID of the device
+ * @param name first part of the names
+ * @param first number of the first name
+ */
+inline void nameUUIDs(uint8_t uuids[][16], uint16_t count, const uint8_t ns[], const char name[], uint16_t first = 0) {
+	UUIDHash prefix;
+	uuidHashInit(prefix);
+	uuidHashWrite(prefix, ns, 16);
+	uuidHashWrite(prefix, (const uint8_t*)name, strlen(name));
+	for (uint16_t n = 0; n < count; n++) {
+		char digits[5];
+		uint8_t size = 0;
+		uint16_t number = first + n;
+		do {
+			digits[4 - size++] = '0' + number % 10;
+			number /= 10;
+			} while (number > 0);
+		UUIDHash hash = prefix;
+		uuidHashWrite(hash, (const uint8_t*)digits + 5 - size, size);
+		uuidHashUUID(hash, uuids[n]);
+		}
+	}
+
 /**
  * @brief converts the UUID to a string
  * 
  * @param uuid 
  * @param uuidString 
  */
-void printUUID(uint8_t uuid[], char uuidString[]) {
-	sprintf(uuidString, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-	uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
-	uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
+inline void printUUID(uint8_t uuid[], char uuidString[]) {
+	formatUUID(uuid, uuidString);
 	}
 
 /**
@@ -90,11 +322,9 @@ void printUUID(uint8_t uuid[], char uuidString[]) {
  * @param uuid 
  * @return char* uuid tring 
  */
-char* printUUID(uint8_t uuid[]) {
+inline char* printUUID(uint8_t uuid[]) {
 	static char uuidString[70];
-	sprintf(uuidString, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-	uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
-	uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
+	formatUUID(uuid, uuidString);
 	return uuidString;
 	}
 
@@ -104,7 +334,7 @@ char* printUUID(uint8_t uuid[]) {
  * @param mac 
  * @param srnd start number for random function
  */
-void generateMAC(uint8_t mac[], unsigned int srnd) {
+inline void generateMAC(uint8_t mac[], unsigned int srnd) {
 	srand(srnd);
 	for (uint8_t i = 0; i < 6; i++) {
 		mac[i] = rand() %256;
@@ -120,7 +350,7 @@ void generateMAC(uint8_t mac[], unsigned int srnd) {
  * @param srnd start number for random function
  * @return uint8_t* MAC address
  */
-uint8_t* generateMAC(unsigned int srnd) {
+inline uint8_t* generateMAC(unsigned int srnd) {
 	static uint8_t mac[6];
 	srand(srnd);
 	for (uint8_t i = 0; i < 6; i++) {
@@ -138,9 +368,12 @@ uint8_t* generateMAC(unsigned int srnd) {
  * @param mac 
  * @param macString 
  */
-void printMAC(uint8_t mac[], char macString[]) {
-	sprintf(macString, "%02X:%02X:%02X:%02X:%02X:%02X",
-	mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+inline void printMAC(uint8_t mac[], char macString[]) {
+	for (uint8_t i = 0; i < 6; i++) {
+		macString[i * 3] = UUID_HEX[mac[i] >> 4];
+		macString[i * 3 + 1] = UUID_HEX[mac[i] & 0x0F];
+		macString[i * 3 + 2] = i < 5 ? ':' : 0;
+		}
 	}
 
 /**
@@ -149,10 +382,9 @@ void printMAC(uint8_t mac[], char macString[]) {
  * @param mac 
  * @return char* MAC string
  */
-char* printMAC(uint8_t mac[]) {
+inline char* printMAC(uint8_t mac[]) {
 	static char macString[31];
-	sprintf(macString, "%02X:%02X:%02X:%02X:%02X:%02X",
-	mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+	printMAC(mac, macString);
 	return macString;
 	}
 
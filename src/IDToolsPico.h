@@ -34,7 +34,7 @@
  * 
  * @param uuid array of 16 bytes
  */
-void generateUUID(uint8_t uuid[]) {
+inline void generateUUID(uint8_t uuid[]) {
 	uint32_t rnd1 = get_rand_32();
 	uuid[0] = rnd1 >> 24;
 	uuid[1] = rnd1 >> 16;
@@ -65,7 +65,7 @@ void generateUUID(uint8_t uuid[]) {
  * 
  * @return uint8_t* uuid
  */
-uint8_t* generateUUID() {
+inline uint8_t* generateUUID() {
 	static uint8_t uuid[16];
 	uint32_t rnd1 = get_rand_32();
 	uuid[0] = rnd1 >> 24;
@@ -99,7 +99,7 @@ uint8_t* generateUUID() {
  * @param uuid 
  * @return uint8_t version number, 0 if fail
  */
-uint8_t verifyUUID(uint8_t uuid[]) {
+inline uint8_t verifyUUID(uint8_t uuid[]) {
 	uint8_t version = uuid[6] >> 4;
 	if ((version > 0) && (version < 8) && (uuid[8] >> 6 == 0x02)) { // check for version and variant
 		return version;
@@ -115,7 +115,7 @@ uint8_t verifyUUID(uint8_t uuid[]) {
  * @param uuid 
  * @param uuidString 36 chars wide
  */
-void printUUID(uint8_t uuid[], char uuidString[]) {
+inline void printUUID(uint8_t uuid[], char uuidString[]) {
 	sprintf(uuidString, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
 	uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
 	uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
@@ -127,7 +127,7 @@ void printUUID(uint8_t uuid[], char uuidString[]) {
  * @param uuid 
  * @return char* uuid tring 
  */
-char* printUUID(uint8_t uuid[]) {
+inline char* printUUID(uint8_t uuid[]) {
 	static char uuidString[37];
 	sprintf(uuidString, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
 	uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
@@ -140,7 +140,7 @@ char* printUUID(uint8_t uuid[]) {
  * 
  * @param mac 
  */
-void generateMAC(uint8_t mac[]) {
+inline void generateMAC(uint8_t mac[]) {
 	uint32_t rnd1 = get_rand_32();
 	mac[0] = rnd1 >> 24;
 	mac[1] = rnd1 >> 16;
@@ -160,7 +160,7 @@ void generateMAC(uint8_t mac[]) {
  * 
  * @return uint8_t* MAC address
  */
-uint8_t* generateMAC() {
+inline uint8_t* generateMAC() {
 	static uint8_t mac[6];
 	uint32_t rnd1 = get_rand_32();
 	mac[0] = rnd1 >> 24;
@@ -183,7 +183,7 @@ uint8_t* generateMAC() {
  * @param mac 
  * @param macString 
  */
-void printMAC(uint8_t mac[], char macString[]) {
+inline void printMAC(uint8_t mac[], char macString[]) {
 	sprintf(macString, "%02X:%02X:%02X:%02X:%02X:%02X",
 	mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 	}
@@ -194,7 +194,7 @@ void printMAC(uint8_t mac[], char macString[]) {
  * @param mac 
  * @return char* MAC string
  */
-char* printMAC(uint8_t mac[]) {
+inline char* printMAC(uint8_t mac[]) {
 	static char macString[18];
 	sprintf(macString, "%02X:%02X:%02X:%02X:%02X:%02X",
 	mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
@@ -14,24 +14,84 @@
 
 #include "sACN.h"
 #include "sACNDefs.h"
+#include "sACNTimer.h"
+#include "sACNSourceTable.h"
+#include "sACNInterpolator.h"
+#include "sACNCurve.h"
+
+static void initHeader(uint8_t *packet, uint16_t universe, uint8_t priority, const uint8_t cid[16], const char name[64]);
+
+// one header template for all sources of the device
+static uint8_t headerTemplate[DMX_VALUES_ADDR];
+static bool headerValid = false;
 
 uint8_t globalCID[16] = {0};
 void deviceCID(uint8_t cid[16]) {
 	memcpy(globalCID, cid, 16);
+	headerValid = false;
 	}
 
 char globalName[64] = {0};
 void deviceName(const char name[64]) {
 	strncpy(globalName, name, 63);
+	headerValid = false;
 	}
 
 Receiver::Receiver(UDP& udp) {
 	this->udp = &udp;
 	sacnPacket = new uint8_t [SACN_BUFFER_MAX];
+	sourceTable = NULL;
+	timerWheel = NULL;
+	timeoutTimer = NULL;
+	framerateTimer = NULL;
+	interpolator = NULL;
+	curveStage = NULL;
+	changeCount = 0;
+	packetCount = 0;
+	processedCount = 0;
+	supersededCount = 0;
+	draining = false;
+	dispatchTable = NULL;
+	ignoredCount = 0;
+	callDMXFunction = NULL;
+	callSourceFunction = NULL;
+	callTimeoutFunction = NULL;
+	callFramerateFunction = NULL;
+	source = {};
+	}
+
+Receiver::Receiver() {
+	udp = NULL;
+	sacnPacket = NULL;
+	sourceTable = NULL;
+	timerWheel = NULL;
+	timeoutTimer = NULL;
+	framerateTimer = NULL;
+	interpolator = NULL;
+	curveStage = NULL;
+	changeCount = 0;
+	packetCount = 0;
+	processedCount = 0;
+	supersededCount = 0;
+	draining = false;
+	dispatchTable = NULL;
+	ignoredCount = 0;
+	callDMXFunction = NULL;
+	callSourceFunction = NULL;
+	callTimeoutFunction = NULL;
+	callFramerateFunction = NULL;
+	source = {};
 	}
 
 Receiver::~Receiver() {
+	if(timerWheel != NULL) {
+		timerWheel->stop(*timeoutTimer);
+		timerWheel->stop(*framerateTimer);
+		}
+	delete timeoutTimer;
+	delete framerateTimer;
 	free(sacnPacket);
+	delete[] dispatchTable;
 	}
 
 void Receiver::begin(uint16_t universe, bool unicastMode) {
@@ -39,114 +99,285 @@ void Receiver::begin(uint16_t universe, bool unicastMode) {
 	this->unicastMode = unicastMode;
 	mcastIP[2] = universe >> 8;
 	mcastIP[3] = universe;
-	if(unicastMode) udp->begin(ACN_SDT_MULTICAST_PORT);
-	else udp->beginMulticast(mcastIP, ACN_SDT_MULTICAST_PORT);
-	receiverTimeout = millis();
+	if(udp != NULL) {
+		if(unicastMode) udp->begin(ACN_SDT_MULTICAST_PORT);
+		else udp->beginMulticast(mcastIP, ACN_SDT_MULTICAST_PORT);
+		}
+	receiverTimeout = deviceMillis();
 	}
 
 void Receiver::stop() {
-	udp->stop();
+	if(udp != NULL) udp->stop();
 	}
 
 bool Receiver::update() {
+	return update(deviceMillis());
+	}
+
+bool Receiver::update(uint32_t now) {
+	expire(now);
+	if(udp == NULL) return false;
 	packetSize = udp->parsePacket();
-	if(source.active && ((receiverTimeout + E131_NETWORK_DATA_LOSS_TIMEOUT) < millis())) {
+	if(packetSize > 0 && packetSize <= SACN_BUFFER_MAX) {
+		processedCount++;
+		udp->read(sacnPacket, SACN_BUFFER_MAX);
+		return process(sacnPacket, packetSize, now);
+		}
+	return false;
+	}
+
+uint8_t Receiver::drain(uint8_t budget) {
+	uint32_t now = deviceMillis();
+	expire(now);
+	if(udp == NULL) return 0;
+	uint8_t valid = 0;
+	uint32_t changes = changeCount;
+	// the DMX callback is called once with the final state
+	draining = true;
+	while(budget-- > 0) {
+		int size = udp->parsePacket();
+		if(size <= 0) break;
+		if(size > SACN_BUFFER_MAX) continue;
+		processedCount++;
+		udp->read(sacnPacket, SACN_BUFFER_MAX);
+		if(process(sacnPacket, size, now)) valid++;
+		}
+	draining = false;
+	if(valid > 1) supersededCount += valid - 1;
+	if(changeCount != changes && callDMXFunction != NULL) callDMXFunction();
+	return valid;
+	}
+
+void Receiver::expire(uint32_t now) {
+	// with a timer wheel the timeout is a timer
+	if(timerWheel == NULL && source.active && ((uint32_t)(now - receiverTimeout) > E131_NETWORK_DATA_LOSS_TIMEOUT)) {
 		source = {};
 		if (callTimeoutFunction != NULL) callTimeoutFunction();
 		}
-	if(packetSize > 0 && packetSize <= SACN_BUFFER_MAX) {
-		udp->read(sacnPacket, SACN_BUFFER_MAX);
-		if(parse()) {
-			receiverTimeout = millis();
-			return true;
-			}
+	}
+
+bool Receiver::process(uint8_t *packet, uint16_t size) {
+	return process(packet, size, deviceMillis());
+	}
+
+bool Receiver::process(uint8_t *packet, uint16_t size, uint32_t now) {
+	if(size < SACN_BUFFER_MIN || size > SACN_BUFFER_MAX) return false;
+	packetSize = size;
+	if(parse(packet, now)) {
+		packetCount++;
+		receiverTimeout = now;
+		if(timerWheel != NULL) timerWheel->start(*timeoutTimer, E131_NETWORK_DATA_LOSS_TIMEOUT, now);
+		return true;
 		}
 	return false;
 	}
 
-bool Receiver::parse() {
+bool Receiver::parse(uint8_t *packet, uint32_t now) {
 	// verify root layer
-	if (sacnPacket[PREAMBLE_ADDR] != PREAMBLE[0]) return false;
-	if (sacnPacket[PREAMBLE_ADDR + 1] != PREAMBLE[1]) return false;
-	if (sacnPacket[POSTAMBLE_ADDR] != POSTAMBLE[0]) return false;
-	if (sacnPacket[POSTAMBLE_ADDR + 1] != POSTAMBLE[1]) return false;
+	if (packet[PREAMBLE_ADDR] != PREAMBLE[0]) return false;
+	if (packet[PREAMBLE_ADDR + 1] != PREAMBLE[1]) return false;
+	if (packet[POSTAMBLE_ADDR] != POSTAMBLE[0]) return false;
+	if (packet[POSTAMBLE_ADDR + 1] != POSTAMBLE[1]) return false;
 	for (uint8_t i = 0; i < ACN_IDENTIFIER_SIZE ; i++) {
-		if (sacnPacket[i + ACN_IDENTIFIER_ADDR] != ACN_IDENTIFIER[i]) return false;
+		if (packet[i + ACN_IDENTIFIER_ADDR] != ACN_IDENTIFIER[i]) return false;
 		}
-	rootFlagAndLength = flagAndLength(sacnPacket[ROOT_FLAGS_AND_LENGTH_ADDR], sacnPacket[ROOT_FLAGS_AND_LENGTH_ADDR +1], ROOT_FLAGS_AND_LENGTH_ADDR);
+	rootFlagAndLength = flagAndLength(packet[ROOT_FLAGS_AND_LENGTH_ADDR], packet[ROOT_FLAGS_AND_LENGTH_ADDR +1], ROOT_FLAGS_AND_LENGTH_ADDR);
 	if (packetSize != rootFlagAndLength) return false;
 	for (uint8_t i = 0; i < VECTOR_ROOT_E131_DATA_SIZE ; i++) {
-		if (sacnPacket[i + VECTOR_ROOT_E131_DATA_ADDR] != VECTOR_ROOT_E131_DATA[i]) return false;
+		if (packet[i + VECTOR_ROOT_E131_DATA_ADDR] != VECTOR_ROOT_E131_DATA[i]) return false;
 		}
 
 	// verify framing layer
-	framingFlagAndLength = flagAndLength(sacnPacket[FRAMING_FLAGS_AND_LENGTH_ADDR], sacnPacket[FRAMING_FLAGS_AND_LENGTH_ADDR +1], FRAMING_FLAGS_AND_LENGTH_ADDR);
+	framingFlagAndLength = flagAndLength(packet[FRAMING_FLAGS_AND_LENGTH_ADDR], packet[FRAMING_FLAGS_AND_LENGTH_ADDR +1], FRAMING_FLAGS_AND_LENGTH_ADDR);
 	if (packetSize != framingFlagAndLength) return false;
 	for (uint8_t i = 0; i < VECTOR_E131_DATA_PACKET_SIZE ; i++) {
-		if (sacnPacket[i + VECTOR_E131_DATA_PACKET_ADDR] != VECTOR_E131_DATA_PACKET[i]) return false;
+		if (packet[i + VECTOR_E131_DATA_PACKET_ADDR] != VECTOR_E131_DATA_PACKET[i]) return false;
 		}
-	priority = sacnPacket[PRIORITY_ADDR];
-	if (priority > PRIORITY_MAX) return false;
-	seqNumber = sacnPacket[SEQ_NUM_ADDR];
-	if (sacnPacket[OPTIONS_ADDR] != 0) {
+	packetPriority = packet[PRIORITY_ADDR];
+	if (packetPriority > PRIORITY_MAX) return false;
+	seqNumber = packet[SEQ_NUM_ADDR];
+	if (packet[OPTIONS_ADDR] != 0) {
 		// TODO clear source if bit 6 true for 3 packets (stream terminated), then make a timeout callback
 		return false;
 		}
-	if (universe != ((sacnPacket[UNIVERSE_ADDR] << 8) + sacnPacket[UNIVERSE_ADDR + 1])) return false;
+	if (universe != ((packet[UNIVERSE_ADDR] << 8) + packet[UNIVERSE_ADDR + 1])) return false;
 
 	// verify data layer
-	dmpFlagAndLength = flagAndLength(sacnPacket[DMP_FLAGS_AND_LENGTH_ADDR], sacnPacket[DMP_FLAGS_AND_LENGTH_ADDR +1], DMP_FLAGS_AND_LENGTH_ADDR);
+	dmpFlagAndLength = flagAndLength(packet[DMP_FLAGS_AND_LENGTH_ADDR], packet[DMP_FLAGS_AND_LENGTH_ADDR +1], DMP_FLAGS_AND_LENGTH_ADDR);
 	if (packetSize != dmpFlagAndLength) return false;
-	if (sacnPacket[VECTOR_DMP_SET_PROPERTY_ADDR] != VECTOR_DMP_SET_PROPERTY) return false;
-	if (sacnPacket[DMP_ADDRESS_AND_DATA_ADDR] != DMP_ADDRESS_AND_DATA) return false;
-	if (sacnPacket[FIRST_PROPERTY_ADDRESS_ADDR] != FIRST_PROPERTY_ADDRESS[0]) return false;
-	if (sacnPacket[FIRST_PROPERTY_ADDRESS_ADDR + 1] != FIRST_PROPERTY_ADDRESS[1]) return false;
-	if (sacnPacket[ADDRESS_INC_ADDR] != ADDRESS_INC[0]) return false;
-	if (sacnPacket[ADDRESS_INC_ADDR + 1] != ADDRESS_INC[1]) return false;
-	propertyValueCount = (sacnPacket[PROPERTY_VALUE_COUNT_ADDR] << 8) + sacnPacket[PROPERTY_VALUE_COUNT_ADDR + 1];
+	if (packet[VECTOR_DMP_SET_PROPERTY_ADDR] != VECTOR_DMP_SET_PROPERTY) return false;
+	if (packet[DMP_ADDRESS_AND_DATA_ADDR] != DMP_ADDRESS_AND_DATA) return false;
+	if (packet[FIRST_PROPERTY_ADDRESS_ADDR] != FIRST_PROPERTY_ADDRESS[0]) return false;
+	if (packet[FIRST_PROPERTY_ADDRESS_ADDR + 1] != FIRST_PROPERTY_ADDRESS[1]) return false;
+	if (packet[ADDRESS_INC_ADDR] != ADDRESS_INC[0]) return false;
+	if (packet[ADDRESS_INC_ADDR + 1] != ADDRESS_INC[1]) return false;
+	propertyValueCount = (packet[PROPERTY_VALUE_COUNT_ADDR] << 8) + packet[PROPERTY_VALUE_COUNT_ADDR + 1];
 	if ((packetSize - STARTCODE_ADDR) != propertyValueCount) return false;
-	if (sacnPacket[STARTCODE_ADDR] != STARTCODE_DMX) return false;
+	if (packet[STARTCODE_ADDR] != STARTCODE_DMX) return dispatch(packet);
 
 	// copy message data to cid
-	memcpy(cid, sacnPacket + CID_ADDR, CID_SIZE);
-	//init source, init source with higher priority, init new source after timeout
-	uint32_t timeout = millis() - source.timestamp;
-	if ((source.active == false) || (priority > source.priority) || (timeout > E131_NETWORK_DATA_LOSS_TIMEOUT)) {
-		memcpy(source.cid, sacnPacket + CID_ADDR, CID_SIZE);
-		memcpy(source.name, sacnPacket + SOURCE_NAME_ADDR, SOURCE_NAME_SIZE - 1);
-		source.priority = priority;
+	memcpy(packetCID, packet + CID_ADDR, CID_SIZE);
+	bool newSource;
+	if (sourceTable != NULL) {
+		// the table selects the source and verifies the sequence number
+		int8_t state = sourceTable->accept(tableIndex, packet, now);
+		if (state == SOURCE_REJECT) return false;
+		newSource = (state == SOURCE_NEW) || (source.active == false);
+		}
+	else {
+		//init source, init source with higher priority, init new source after timeout
+		uint32_t timeout = now - source.timestamp;
+		newSource = (source.active == false) || (packetPriority > source.priority) || (timeout > E131_NETWORK_DATA_LOSS_TIMEOUT);
+		}
+	if (newSource) {
+		memcpy(source.cid, packet + CID_ADDR, CID_SIZE);
+		// with a source table the name is refreshed by the table
+		if (sourceTable == NULL) memcpy(source.name, packet + SOURCE_NAME_ADDR, SOURCE_NAME_SIZE - 1);
+		source.priority = packetPriority;
 		source.active = true;
 		source.newSource = true;
 		if (callSourceFunction != NULL) callSourceFunction();
-		source.frameRateTimestamp = millis();
+		source.frameRateTimestamp = now;
 		source.frameRateCount = 1;
+		if (timerWheel != NULL) timerWheel->start(*framerateTimer, SACN_FRAMERATE_TIME, now);
+		}
+	if (sourceTable == NULL) {
+		// verify source
+		if(memcmp(source.cid, packetCID, CID_SIZE) != 0) return false;
+		// verify sequenznumber
+		if (((seqNumber - source.seqNumber) <= 0) && ((seqNumber - source.seqNumber) > -20)) return false;
 		}
-	// verify source
-	if(memcmp(source.cid, cid, CID_SIZE) != 0) return false;
-	// verify sequenznumber
-	if (((seqNumber - source.seqNumber) <= 0) && ((seqNumber - source.seqNumber) > -20)) return false;
 	// update source data
-	source.timestamp = millis();
+	source.timestamp = now;
 	source.seqNumber = seqNumber;
-	// calculate framerate
-	if((source.frameRateTimestamp + 1000) > millis()) {
+	// calculate framerate, with a timer wheel the window is closed by a timer
+	if(timerWheel != NULL || (uint32_t)(now - source.frameRateTimestamp) < SACN_FRAMERATE_TIME) {
 		source.frameRateCount++;
 		}
 	else {
 		source.frameRate = source.frameRateCount;
 		source.frameRateCount = 0;
-		source.frameRateTimestamp = millis();
+		source.frameRateTimestamp = now;
 		if (callFramerateFunction != NULL) callFramerateFunction();
 		}
 	// copy data to dmx buffer 
 	uint16_t dmxLength = packetSize - DMX_VALUES_ADDR;
-	if(memcmp(source.dmx, sacnPacket + DMX_VALUES_ADDR, dmxLength) != 0) {
-		memcpy(source.dmx, sacnPacket + DMX_VALUES_ADDR, dmxLength);
-		if (callDMXFunction != NULL) callDMXFunction();
+	if(memcmp(source.dmx, packet + DMX_VALUES_ADDR, dmxLength) != 0) {
+		memcpy(source.dmx, packet + DMX_VALUES_ADDR, dmxLength);
+		changeCount++;
+		if (curveStage != NULL) curveStage->apply(source.dmx, dmxLength);
+		if (callDMXFunction != NULL && !draining) callDMXFunction();
 		}
+	// the interpolator needs the us clock of output(), so only then the clock is read per packet
+	if (interpolator != NULL) interpolator->frame(packet + DMX_VALUES_ADDR, dmxLength, deviceMicros(), source.frameRate);
 	return true;
 	}
 
+bool Receiver::dispatch(uint8_t *packet) {
+	uint8_t startcode = packet[STARTCODE_ADDR];
+	Dispatch *entry = NULL;
+	if (dispatchTable != NULL) {
+		for (uint8_t i = 0; i < SACN_STARTCODES; i++) {
+			if (dispatchTable[i].handler != NULL && dispatchTable[i].startcode == startcode) {
+				entry = &dispatchTable[i];
+				break;
+				}
+			}
+		}
+	if (entry == NULL) {
+		ignoredCount++;
+		return false;
+		}
+	// only the selected source, without DMX packets there is no source to trust
+	if (!source.active) return false;
+	if (memcmp(source.cid, packet + CID_ADDR, CID_SIZE) != 0) return false;
+	// the sequence numbers are shared with the DMX packets
+	if (((seqNumber - source.seqNumber) <= 0) && ((seqNumber - source.seqNumber) > -20)) return false;
+	source.seqNumber = seqNumber;
+	entry->count++;
+	entry->handler(packet + DMX_VALUES_ADDR, packetSize - DMX_VALUES_ADDR, entry->context);
+	// not DMX data, so the data loss timeout is not refreshed
+	return false;
+	}
+
+bool Receiver::startcode(uint8_t startcode, sptr handler, void *context) {
+	if (startcode == STARTCODE_DMX) return false;
+	if (dispatchTable == NULL) {
+		if (handler == NULL) return true;
+		dispatchTable = new Dispatch [SACN_STARTCODES];
+		for (uint8_t i = 0; i < SACN_STARTCODES; i++) dispatchTable[i].handler = NULL;
+		}
+	int8_t slot = -1;
+	for (uint8_t i = 0; i < SACN_STARTCODES; i++) {
+		if (dispatchTable[i].handler != NULL && dispatchTable[i].startcode == startcode) {
+			dispatchTable[i].handler = handler;
+			dispatchTable[i].context = context;
+			return true;
+			}
+		if (dispatchTable[i].handler == NULL && slot < 0) slot = i;
+		}
+	if (handler == NULL) return true;
+	if (slot < 0) return false;
+	dispatchTable[slot].handler = handler;
+	dispatchTable[slot].context = context;
+	dispatchTable[slot].count = 0;
+	dispatchTable[slot].startcode = startcode;
+	return true;
+	}
+
+uint32_t Receiver::startcodes(uint8_t startcode) {
+	if (startcode == STARTCODE_DMX) return packetCount;
+	if (dispatchTable == NULL) return 0;
+	for (uint8_t i = 0; i < SACN_STARTCODES; i++) {
+		if (dispatchTable[i].handler != NULL && dispatchTable[i].startcode == startcode) return dispatchTable[i].count;
+		}
+	return 0;
+	}
+
+uint32_t Receiver::ignored() {
+	return ignoredCount;
+	}
+
+void Receiver::table(SourceTable &table, uint16_t index) {
+	sourceTable = &table;
+	tableIndex = index;
+	}
+
+void Receiver::wheel(TimerWheel &wheel) {
+	if(timeoutTimer == NULL) {
+		timeoutTimer = new Timer;
+		framerateTimer = new Timer;
+		}
+	timerWheel = &wheel;
+	timeoutTimer->callback(timeoutExpired, this);
+	framerateTimer->callback(framerateExpired, this);
+	}
+
+void Receiver::interpolate(Interpolator &interpolator) {
+	this->interpolator = &interpolator;
+	}
+
+void Receiver::curve(Curve &curve) {
+	curveStage = &curve;
+	}
+
+void Receiver::timeoutExpired(void *context) {
+	Receiver *receiver = (Receiver*)context;
+	if(!receiver->source.active) return;
+	receiver->source = {};
+	receiver->timerWheel->stop(*receiver->framerateTimer);
+	if (receiver->callTimeoutFunction != NULL) receiver->callTimeoutFunction();
+	}
+
+void Receiver::framerateExpired(void *context) {
+	Receiver *receiver = (Receiver*)context;
+	receiver->source.frameRate = receiver->source.frameRateCount;
+	receiver->source.frameRateCount = 0;
+	receiver->source.frameRateTimestamp = deviceMillis();
+	if (receiver->callFramerateFunction != NULL) receiver->callFramerateFunction();
+	if(receiver->source.active) receiver->timerWheel->start(*receiver->framerateTimer, SACN_FRAMERATE_TIME);
+	}
+
 void Receiver::callbackDMX(fptr callDMX) {
 	callDMXFunction = callDMX;
 	}
@@ -171,18 +402,57 @@ void Receiver::dmx(uint8_t *data) {
 	memcpy(data, source.dmx, DMX_SLOTS_MAX);
 	}
 
+void Receiver::restore(const uint8_t *data) {
+	memcpy(source.dmx, data, DMX_SLOTS_MAX);
+	changeCount++;
+	if (curveStage != NULL) curveStage->apply(source.dmx, DMX_SLOTS_MAX);
+	if (callDMXFunction != NULL) callDMXFunction();
+	}
+
 uint8_t Receiver::dmx(uint16_t slot) {
 	if(slot > 0 && slot <= DMX_SLOTS_MAX)
 		return source.dmx[slot - 1];
 	return 0;
 	}
 
+uint32_t Receiver::changes() {
+	return changeCount;
+	}
+
+uint32_t Receiver::packets() {
+	return packetCount;
+	}
+
+uint8_t Receiver::sequence() {
+	return source.seqNumber;
+	}
+
+uint8_t* Receiver::cid() {
+	return source.cid;
+	}
+
 char* Receiver::name() {
+	if (sourceTable != NULL) {
+		int16_t index = sourceTable->selected(tableIndex);
+		if (source.active && index >= 0) return (char*)sourceTable->name(index);
+		}
 	return source.name;
 	}
 
 void Receiver::name(char *sourceName) {
-	memcpy(sourceName, source.name, SOURCE_NAME_SIZE);
+	memcpy(sourceName, name(), SOURCE_NAME_SIZE);
+	}
+
+uint32_t Receiver::processed() {
+	return processedCount;
+	}
+
+uint32_t Receiver::superseded() {
+	return supersededCount;
+	}
+
+uint8_t Receiver::priority() {
+	return source.priority;
 	}
 
 uint8_t Receiver::framerate() {
@@ -200,12 +470,25 @@ uint16_t Receiver::flagAndLength(uint8_t highByte, uint8_t lowByte, uint16_t sta
 
 Source::Source(UDP& udp) {
 	this->udp = &udp;
+	timerWheel = NULL;
+	keepAliveTimer = NULL;
+	keepAliveDDTimer = NULL;
+	dmxData = NULL;
+	ddData = NULL;
+	destinationList = NULL;
+	destinationCount = 0;
 	}
 
 Source::~Source() {
-	free(sacnPacket);
-	if(priorityDD == true) 
-		free(sacnPacketDD);
+	if(timerWheel != NULL) {
+		timerWheel->stop(*keepAliveTimer);
+		timerWheel->stop(*keepAliveDDTimer);
+		}
+	delete keepAliveTimer;
+	delete keepAliveDDTimer;
+	delete[] dmxData;
+	delete[] ddData;
+	delete[] destinationList;
 	}
 
 void Source::begin(uint16_t universe, uint16_t priority, bool priorityDD) {
@@ -215,22 +498,9 @@ void Source::begin(uint16_t universe, uint16_t priority, bool priorityDD) {
 	unicastMode = false;
 	mcastIP[2] = universe >> 8;
 	mcastIP[3] = universe;
-	sacnPacket = new uint8_t [SACN_BUFFER_MAX];
-	initPacket(sacnPacket);
-	if(priorityDD == true) {
-		sacnPacketDD = new uint8_t [SACN_BUFFER_MAX];
-		initPacket(sacnPacketDD);
-		sacnPacketDD[STARTCODE_ADDR] = 0xDD;
-		memset(sacnPacketDD + DMX_VALUES_ADDR, priority, DMX_SLOTS_MAX );
-		}
+	initPayload();
 	udp->beginMulticast(mcastIP, ACN_SDT_MULTICAST_PORT);
-	for(uint8_t i = 0; i < 3; i++) {
-		send();
-		if(priorityDD) sendDD();
-		delay(40); // TODO non block
-		}
-	timestamp = millis();
-	timestampDD = millis();
+	sendStart();
 	}
 
 void Source::begin(IPAddress ip, uint16_t universe, uint16_t priority, bool priorityDD) {
@@ -241,98 +511,210 @@ void Source::begin(IPAddress ip, uint16_t universe, uint16_t priority, bool prio
 	unicastMode = true;
 	mcastIP[2] = universe >> 8;
 	mcastIP[3] = universe;
-	sacnPacket = new uint8_t [SACN_BUFFER_MAX];
-	initPacket(sacnPacket);
-	if(priorityDD == true) {
-		sacnPacketDD = new uint8_t [SACN_BUFFER_MAX];
-		initPacket(sacnPacketDD);
-		sacnPacketDD[STARTCODE_ADDR] = 0xDD;
-		memset(sacnPacketDD + DMX_VALUES_ADDR, priority, DMX_SLOTS_MAX );
-		}
+	initPayload();
 	udp->begin(ACN_SDT_MULTICAST_PORT);
-	for(uint8_t i = 0; i < 3; i++) {
-		send();
-		if(priorityDD) sendDD();
-		delay(40); // TODO non block
+	sendStart();
+	}
+
+void Source::begin(IPAddress destinations[], uint8_t count, uint16_t universe, uint16_t priority, bool priorityDD) {
+	this->universe = universe;
+	this->priority = priority;
+	this->priorityDD = priorityDD;
+	// without destinations the stream falls back to the multicast address of the universe
+	unicastMode = false;
+	mcastIP[2] = universe >> 8;
+	mcastIP[3] = universe;
+	destinationCount = 0;
+	for(uint8_t i = 0; i < count; i++) add(destinations[i]);
+	initPayload();
+	udp->begin(ACN_SDT_MULTICAST_PORT);
+	sendStart();
+	}
+
+bool Source::add(IPAddress ip) {
+	initDestinations();
+	for(uint8_t i = 0; i < destinationCount; i++) {
+		if(destinationList[i] == ip) return false;
+		}
+	if(destinationCount >= SACN_DESTINATIONS) return false;
+	destinationList[destinationCount++] = ip;
+	return true;
+	}
+
+bool Source::remove(IPAddress ip) {
+	for(uint8_t i = 0; i < destinationCount; i++) {
+		if(destinationList[i] == ip) {
+			// the order of the destinations doesn't matter
+			destinationList[i] = destinationList[--destinationCount];
+			return true;
+			}
 		}
-	timestamp = millis();
-	timestampDD = millis();
+	return false;
+	}
+
+uint8_t Source::destinations() {
+	return destinationCount;
 	}
 
 void Source::stop() {
-	sacnPacket[OPTIONS_ADDR] = STREAM_TERMINATED;
-	if(priorityDD) sacnPacketDD[OPTIONS_ADDR] = STREAM_TERMINATED;
+	options = STREAM_TERMINATED;
 	for(uint8_t i = 0; i < 3; i++) {
 		send();
 		if(priorityDD) sendDD();
 		delay(40);
 		}
+	if(timerWheel != NULL) {
+		timerWheel->stop(*keepAliveTimer);
+		timerWheel->stop(*keepAliveDDTimer);
+		}
 	udp->stop();
 	}
 
 void Source::dmx(uint8_t *data) {
-	memcpy(sacnPacket + DMX_VALUES_ADDR, data, DMX_SLOTS_MAX);
+	memcpy(dmxData, data, DMX_SLOTS_MAX);
+	}
+
+uint8_t* Source::dmx() {
+	return dmxData;
 	}
 
 void Source::dmx(uint16_t slot, uint8_t data) {
 	if(slot > 0 && slot <= DMX_SLOTS_MAX) {
-		sacnPacket[DMX_VALUES_ADDR + slot - 1] = data;
+		dmxData[slot - 1] = data;
 		}
 	}
 
 void Source::dd(uint8_t *priorityData) {
 	if(priorityDD) {
-		memcpy(sacnPacketDD + DMX_VALUES_ADDR, priorityData, DMX_SLOTS_MAX);
+		memcpy(ddData, priorityData, DMX_SLOTS_MAX);
 		}
 	}
 
 void Source::dd(uint16_t slot, uint8_t priorityData) {
 	if(priorityDD) {
 		if(slot > 0 && slot <= DMX_SLOTS_MAX) {
-			sacnPacketDD[DMX_VALUES_ADDR + slot - 1] = priorityData;
+			ddData[slot - 1] = priorityData;
 			}
 		}
 	}
 
 void Source::send() {
-	if(unicastMode) udp->beginPacket(ip, ACN_SDT_MULTICAST_PORT);
-	else udp->beginPacket(mcastIP, ACN_SDT_MULTICAST_PORT);
-	udp->write(sacnPacket, SACN_BUFFER_MAX);
-	udp->endPacket();
-	timestamp = millis();
-	sacnPacket[SEQ_NUM_ADDR]++;
+	send(deviceMillis());
+	}
+
+void Source::send(uint32_t now) {
+	write(STARTCODE_DMX, dmxData);
+	timestamp = now;
+	seqNumber++;
+	if(timerWheel != NULL) timerWheel->start(*keepAliveTimer, SACN_POLLING_TIME, now);
 	}
 
 void Source::idle() {
-	if(millis() > timestamp + SACN_POLLING_TIME) {
-		send();
-		timestamp = millis();
+	if(timerWheel != NULL) return;
+	uint32_t now = deviceMillis();
+	if((uint32_t)(now - timestamp) > SACN_POLLING_TIME) {
+		send(now);
 		}
 	}
 
 void Source::sendDD() {
+	sendDD(deviceMillis());
+	}
+
+void Source::sendDD(uint32_t now) {
 	if(priorityDD) {
-		sacnPacketDD[SEQ_NUM_ADDR] = sacnPacket[SEQ_NUM_ADDR];
-		if(unicastMode) udp->beginPacket(ip, ACN_SDT_MULTICAST_PORT);
-		else udp->beginPacket(mcastIP, ACN_SDT_MULTICAST_PORT);
-		udp->write(sacnPacketDD, SACN_BUFFER_MAX);
-		udp->endPacket();
-		sacnPacket[SEQ_NUM_ADDR]++;
-		timestampDD = millis();
+		write(0xDD, ddData);
+		seqNumber++;
+		timestampDD = now;
+		if(timerWheel != NULL) timerWheel->start(*keepAliveDDTimer, SACN_POLLING_TIME_DD, now);
 		}
 	}
 
 void Source::idleDD() {
-	if(priorityDD) {
-		if(millis() > timestampDD + SACN_POLLING_TIME_DD) {
-			sendDD();
-			timestampDD = millis();
+	if(priorityDD && timerWheel == NULL) {
+		uint32_t now = deviceMillis();
+		if((uint32_t)(now - timestampDD) > SACN_POLLING_TIME_DD) {
+			sendDD(now);
 			}
 		}
 	}
 
-void Source::initPacket(uint8_t *packet) {
-	memset(packet, 0x00, SACN_BUFFER_MAX);
+void Source::wheel(TimerWheel &wheel) {
+	if(keepAliveTimer == NULL) {
+		keepAliveTimer = new Timer;
+		keepAliveDDTimer = new Timer;
+		}
+	timerWheel = &wheel;
+	keepAliveTimer->callback(keepAliveExpired, this);
+	keepAliveDDTimer->callback(keepAliveDDExpired, this);
+	// without begin() there is nothing to send, the first packets of begin() start the timers
+	if(dmxData == NULL) return;
+	timerWheel->start(*keepAliveTimer, SACN_POLLING_TIME);
+	if(priorityDD) timerWheel->start(*keepAliveDDTimer, SACN_POLLING_TIME_DD);
+	}
+
+void Source::keepAliveExpired(void *context) {
+	((Source*)context)->send();
+	}
+
+void Source::keepAliveDDExpired(void *context) {
+	((Source*)context)->sendDD();
+	}
+
+void Source::initDestinations() {
+	if(destinationList == NULL) destinationList = new IPAddress [SACN_DESTINATIONS];
+	}
+
+void Source::sendStart() {
+	for(uint8_t i = 0; i < 3; i++) {
+		send();
+		if(priorityDD) sendDD();
+		delay(40); // TODO non block
+		}
+	timestamp = deviceMillis();
+	timestampDD = timestamp;
+	}
+
+void Source::initPayload() {
+	if(dmxData == NULL) dmxData = new uint8_t [DMX_SLOTS_MAX];
+	memset(dmxData, 0, DMX_SLOTS_MAX);
+	if(priorityDD == true) {
+		if(ddData == NULL) ddData = new uint8_t [DMX_SLOTS_MAX];
+		memset(ddData, priority, DMX_SLOTS_MAX);
+		}
+	seqNumber = 0;
+	options = 0;
+	}
+
+void Source::write(uint8_t startcode, const uint8_t *payload) {
+	if(!headerValid) {
+		initHeader(headerTemplate, 0, 0, globalCID, globalName);
+		headerValid = true;
+		}
+	// fields of the stream from priority to universe
+	uint8_t fields[UNIVERSE_ADDR + 2 - PRIORITY_ADDR] = {priority, 0, 0, seqNumber, options, (uint8_t)(universe >> 8), (uint8_t)universe};
+	// the fields are built once, so every destination gets the same sequence number
+	uint8_t count = destinationCount > 0 ? destinationCount : 1;
+	for(uint8_t i = 0; i < count; i++) {
+		if(destinationCount > 0) udp->beginPacket(destinationList[i], ACN_SDT_MULTICAST_PORT);
+		else if(unicastMode) udp->beginPacket(ip, ACN_SDT_MULTICAST_PORT);
+		else udp->beginPacket(mcastIP, ACN_SDT_MULTICAST_PORT);
+		udp->write(headerTemplate, PRIORITY_ADDR);
+		udp->write(fields, sizeof(fields));
+		udp->write(headerTemplate + DMP_FLAGS_AND_LENGTH_ADDR, STARTCODE_ADDR - DMP_FLAGS_AND_LENGTH_ADDR);
+		udp->write(startcode);
+		udp->write(payload, DMX_SLOTS_MAX);
+		udp->endPacket();
+		}
+	}
+
+void Source::initPacket(uint8_t *packet, uint16_t universe, uint8_t priority, const uint8_t cid[16], const char name[64]) {
+	initHeader(packet, universe, priority, cid, name);
+	memset(packet + DMX_VALUES_ADDR, 0x00, DMX_SLOTS_MAX);
+	}
+
+static void initHeader(uint8_t *packet, uint16_t universe, uint8_t priority, const uint8_t cid[16], const char name[64]) {
+	memset(packet, 0x00, DMX_VALUES_ADDR);
 	// root layer
 	packet[PREAMBLE_ADDR] = PREAMBLE[0];
 	packet[PREAMBLE_ADDR + 1] = PREAMBLE[1];
@@ -341,11 +723,11 @@ void Source::initPacket(uint8_t *packet) {
 	memcpy(packet + ACN_IDENTIFIER_ADDR, ACN_IDENTIFIER, ACN_IDENTIFIER_SIZE);
 	memcpy(packet + ROOT_FLAGS_AND_LENGTH_ADDR, ROOT_FLAGS_AND_LENGTH, ROOT_FLAGS_AND_LENGTH_SIZE);
 	memcpy(packet + VECTOR_ROOT_E131_DATA_ADDR, VECTOR_ROOT_E131_DATA, VECTOR_ROOT_E131_DATA_SIZE);
-	memcpy(packet + CID_ADDR, globalCID, CID_SIZE);
+	memcpy(packet + CID_ADDR, cid, CID_SIZE);
 	// framing layer
 	memcpy(packet + FRAMING_FLAGS_AND_LENGTH_ADDR, FRAMING_FLAGS_AND_LENGTH, FRAMING_FLAGS_AND_LENGTH_SIZE);
 	memcpy(packet + VECTOR_E131_DATA_PACKET_ADDR, VECTOR_E131_DATA_PACKET, VECTOR_E131_DATA_PACKET_SIZE);
-	memcpy(packet + SOURCE_NAME_ADDR, globalName, SOURCE_NAME_SIZE);
+	strncpy((char*)packet + SOURCE_NAME_ADDR, name, SOURCE_NAME_SIZE - 1);
 	packet[PRIORITY_ADDR] = priority;
 	packet[UNIVERSE_ADDR] = universe >> 8;
 	packet[UNIVERSE_ADDR + 1] = universe;
@@ -17,6 +17,7 @@
 
 #include "Arduino.h"
 #include "Udp.h"
+#include "sACNClock.h"
 
 /*
 TODO for v1.1
@@ -26,6 +27,12 @@ TODO for v1.1
 - [ ] Layer check as functions
 */
 
+class SourceTable;
+class TimerWheel;
+class Timer;
+class Interpolator;
+class Curve;
+
 void deviceCID(uint8_t cid[16]);
 void deviceName(const char name[64]);
 
@@ -35,6 +42,7 @@ void deviceName(const char name[64]);
  */
 class Receiver {
 	typedef void (*fptr)();
+	typedef void (*sptr)(const uint8_t *data, uint16_t length, void *context);
 	public:
 	/**
 	 * @brief Construct a new Receiver object
@@ -45,6 +53,14 @@ class Receiver {
 	 */
 	Receiver(UDP& udp);
 
+	/**
+	 * @brief Construct a new Receiver object without an own socket,
+	 * packets are handed over with process(), e.g. by a Subscription,
+	 * as default constructor it allows arrays of receivers, also on the heap
+	 * 
+	 */
+	Receiver();
+
 	/**
 	 * @brief Destroy the Receiver object
 	 * 
@@ -71,6 +87,105 @@ class Receiver {
 	 */
 	bool update();
 
+	/**
+	 * @brief Receive and proceed incoming data with a time sampled by the caller,
+	 * e.g. once for all receivers of a loop
+	 * 
+	 * @param now time of the library clock in ms
+	 * @return true if valid data received
+	 * @return false if there is no valid data
+	 */
+	bool update(uint32_t now);
+
+	/**
+	 * @brief Receive and proceed all pending packets up to a budget, must inside of loop(),
+	 * the DMX callback is called once with the final state
+	 * 
+	 * @param budget maximum number of packets
+	 * @return uint8_t number of valid packets
+	 */
+	uint8_t drain(uint8_t budget = 8);
+
+	/**
+	 * @brief Proceed a sACN packet received by another socket owner
+	 * 
+	 * @param packet sACN packet buffer
+	 * @param size packet size
+	 * @return true if the packet is valid for this receiver
+	 * @return false if the packet is rejected
+	 */
+	bool process(uint8_t *packet, uint16_t size);
+
+	/**
+	 * @brief Proceed a sACN packet with a time sampled by the caller
+	 * 
+	 * @param packet sACN packet buffer
+	 * @param size packet size
+	 * @param now time of the library clock in ms
+	 * @return true if the packet is valid for this receiver
+	 * @return false if the packet is rejected
+	 */
+	bool process(uint8_t *packet, uint16_t size, uint32_t now);
+
+	/**
+	 * @brief Use a shared source table for source selection and sequence check
+	 * 
+	 * @param table source table
+	 * @param index universe index inside of the table
+	 */
+	void table(SourceTable &table, uint16_t index);
+
+	/**
+	 * @brief Use a shared timer wheel for the data loss timeout and the framerate,
+	 * update() of the wheel must called inside of loop()
+	 * 
+	 * @param wheel timer wheel
+	 */
+	void wheel(TimerWheel &wheel);
+
+	/**
+	 * @brief Hand over every valid DMX frame to an interpolator,
+	 * the framerate of the source sets the interpolation span
+	 * 
+	 * @param interpolator frame interpolator
+	 */
+	void interpolate(Interpolator &interpolator);
+
+	/**
+	 * @brief Apply response curves to changed DMX data before the DMX callback
+	 * 
+	 * @param curve curve stage
+	 */
+	void curve(Curve &curve);
+
+	/**
+	 * @brief Set a handler for an alternate start code, e.g. STARTCODE_DD or STARTCODE_TEST,
+	 * the handler gets the payload inside of the packet buffer without a copy, only packets
+	 * of the selected source are given, so nothing is given before the first DMX packet
+	 * 
+	 * @param startcode start code, not STARTCODE_DMX
+	 * @param handler function name to call, NULL to remove the handler
+	 * @param context pointer given to the function
+	 * @return true if the handler is set or removed
+	 * @return false if there is no space left
+	 */
+	bool startcode(uint8_t startcode, sptr handler, void *context = NULL);
+
+	/**
+	 * @brief Get the number of packets of a start code
+	 * 
+	 * @param startcode start code
+	 * @return uint32_t valid DMX packets or packets given to the handler
+	 */
+	uint32_t startcodes(uint8_t startcode);
+
+	/**
+	 * @brief Get the number of packets with a start code without handler
+	 * 
+	 * @return uint32_t packet counter
+	 */
+	uint32_t ignored();
+
 	/**
 	 * @brief Callback when receiving changed DMX data
 	 * 
@@ -113,6 +228,13 @@ class Receiver {
 	 */
 	void dmx(uint8_t *data);
 
+	/**
+	 * @brief Restore DMX data without a source, e.g. from a snapshot, calls the DMX callback
+	 * 
+	 * @param data DMX universe content
+	 */
+	void restore(const uint8_t *data);
+
 	/**
 	 * @brief Get a single DMX slot
 	 * 
@@ -121,6 +243,34 @@ class Receiver {
 	 */
 	uint8_t dmx(uint16_t slot);
 
+	/**
+	 * @brief Get the number of DMX data changes, e.g. to check for new data without callback
+	 * 
+	 * @return uint32_t change counter
+	 */
+	uint32_t changes();
+
+	/**
+	 * @brief Get the number of valid packets of the selected source
+	 * 
+	 * @return uint32_t packet counter
+	 */
+	uint32_t packets();
+
+	/**
+	 * @brief Get the sequence number of the last packet of the selected source
+	 * 
+	 * @return uint8_t sequence number
+	 */
+	uint8_t sequence();
+
+	/**
+	 * @brief Get the CID of the selected source
+	 * 
+	 * @return uint8_t* source CID
+	 */
+	uint8_t* cid();
+
 	/**
 	 * @brief Get the source name 
 	 * 
@@ -135,6 +285,28 @@ class Receiver {
 	 */
 	void name(char *sourceName);
 
+	/**
+	 * @brief Get the number of packets read from the socket by update() and drain()
+	 * 
+	 * @return uint32_t packet counter
+	 */
+	uint32_t processed();
+
+	/**
+	 * @brief Get the number of valid packets replaced by a later packet of the same drain()
+	 * before the DMX callback
+	 * 
+	 * @return uint32_t packet counter
+	 */
+	uint32_t superseded();
+
+	/**
+	 * @brief Get the priority of the selected source
+	 * 
+	 * @return uint8_t priority 0...200
+	 */
+	uint8_t priority();
+
 	/**
 	 * @brief Get the framerate
 	 * 
@@ -151,7 +323,10 @@ class Receiver {
 	bool sources();
 
 	private:
-	bool parse();
+	friend class EventLoop;
+	bool parse(uint8_t *packet, uint32_t now);
+	void expire(uint32_t now);
+	bool dispatch(uint8_t *packet);
 	uint16_t flagAndLength(uint8_t highByte, uint8_t lowByte, uint16_t startAddress);
 	UDP *udp;
 	uint16_t universe;
@@ -160,6 +335,19 @@ class Receiver {
 	uint8_t *sacnPacket;
 	uint16_t packetSize;
 	uint32_t receiverTimeout;
+	uint32_t changeCount;
+	uint32_t packetCount;
+	uint32_t processedCount;
+	uint32_t supersededCount;
+	bool draining;
+	struct Dispatch {
+		sptr handler;
+		void *context;
+		uint32_t count;
+		uint8_t startcode;
+		};
+	Dispatch *dispatchTable; // allocated with the first handler
+	uint32_t ignoredCount;
 	fptr callDMXFunction;
 	fptr callSourceFunction;
 	fptr callTimeoutFunction;
@@ -167,10 +355,19 @@ class Receiver {
 	uint16_t rootFlagAndLength;
 	uint16_t framingFlagAndLength;
 	uint16_t dmpFlagAndLength;
-	uint8_t cid[16];
+	uint8_t packetCID[16];
 	uint8_t seqNumber;
-	uint8_t priority;
+	uint8_t packetPriority;
 	uint16_t propertyValueCount;
+	SourceTable *sourceTable;
+	uint16_t tableIndex;
+	Interpolator *interpolator;
+	Curve *curveStage;
+	static void timeoutExpired(void *context);
+	static void framerateExpired(void *context);
+	TimerWheel *timerWheel;
+	Timer *timeoutTimer;
+	Timer *framerateTimer;
 	struct Sources {
 		uint8_t cid[16];
 		char name[64];
@@ -217,6 +414,45 @@ class Source {
 	void begin(uint16_t universe, uint16_t priority = 100, bool priorityDD = false);
 	void begin(IPAddress unicastIp, uint16_t universe, uint16_t priority = 100, bool priorityDD = false);
 
+	/**
+	 * @brief Begin the socket connection for sending to a list of unicast destinations,
+	 * with an empty list the packets are sent to the multicast address of the universe
+	 * 
+	 * @param destinations IP addresses of the receivers
+	 * @param count number of destinations
+	 * @param universe DMX universe to send
+	 * @param priority sACN priority
+	 * @param priorityDD flag for sending optional priority per channel mode
+	 */
+	void begin(IPAddress destinations[], uint8_t count, uint16_t universe, uint16_t priority = 100, bool priorityDD = false);
+
+	/**
+	 * @brief Add a unicast destination, the stream fields are built once and sent to all destinations
+	 * with the same sequence number, the destinations replace the address of begin()
+	 * 
+	 * @param ip IP address of the receiver
+	 * @return true if the destination is added
+	 * @return false if the destination exists or the list is full
+	 */
+	bool add(IPAddress ip);
+
+	/**
+	 * @brief Remove a unicast destination, after the last one is removed the packets are
+	 * sent to the address of begin() again, for a list begin() it's the multicast address
+	 * 
+	 * @param ip IP address of the receiver
+	 * @return true if the destination is removed
+	 * @return false if the destination is unknown
+	 */
+	bool remove(IPAddress ip);
+
+	/**
+	 * @brief Get the number of unicast destinations
+	 * 
+	 * @return uint8_t destinations
+	 */
+	uint8_t destinations();
+
 	/**
 	 * @brief Stop the socket connection
 	 * 
@@ -230,6 +466,13 @@ class Source {
 	 */
 	void dmx(uint8_t *data);
 
+	/**
+	 * @brief Get the DMX data for writing without a copy, e.g. by effects
+	 * 
+	 * @return uint8_t* DMX universe content, NULL before begin()
+	 */
+	uint8_t* dmx();
+
 	/**
 	 * @brief Set DMX slot
 	 * 
@@ -277,8 +520,31 @@ class Source {
 	 */
 	void idleDD();
 
+	/**
+	 * @brief Use a shared timer wheel for the keep alive packets instead of idle() and idleDD(),
+	 * update() of the wheel must called inside of loop(), the timers start with begin()
+	 * 
+	 * @param wheel timer wheel
+	 */
+	void wheel(TimerWheel &wheel);
+
+	/**
+	 * @brief Initialize a complete sACN DMX packet
+	 * 
+	 * @param packet buffer with SACN_BUFFER_MAX size
+	 * @param universe DMX universe
+	 * @param priority sACN priority
+	 * @param cid CID of the source
+	 * @param name source name
+	 */
+	static void initPacket(uint8_t *packet, uint16_t universe, uint8_t priority, const uint8_t cid[16], const char name[64]);
+
 	private:
-	void initPacket(uint8_t *packet);
+	friend class EventLoop;
+	void initPayload();
+	void initDestinations();
+	void sendStart();
+	void write(uint8_t startcode, const uint8_t *payload);
 	UDP *udp;
 	uint8_t mcastIP[4] = {239, 255, 0, 0};
 	IPAddress ip;
@@ -287,10 +553,21 @@ class Source {
 	uint16_t universe;
 	uint8_t priority;
 	bool priorityDD;
-	uint8_t *sacnPacket; // sacnPacket = new uint8_t [SACN_BUFFER_MAX];
-	uint8_t *sacnPacketDD; // sacnDDPacket = new uint8_t [SACN_BUFFER_MAX];
+	uint8_t *dmxData; // only the payload, the header is a shared template
+	uint8_t *ddData;
+	IPAddress *destinationList; // fixed capacity, allocated with the first destination
+	uint8_t destinationCount;
+	uint8_t seqNumber;
+	uint8_t options;
 	uint32_t timestamp;
 	uint32_t timestampDD;
+	void send(uint32_t now);
+	void sendDD(uint32_t now);
+	static void keepAliveExpired(void *context);
+	static void keepAliveDDExpired(void *context);
+	TimerWheel *timerWheel;
+	Timer *keepAliveTimer;
+	Timer *keepAliveDDTimer;
 	};
 
 #endif
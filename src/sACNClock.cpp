@@ -0,0 +1,23 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNClock.h"
+
+clockptr clockMillis = NULL;
+clockptr clockMicros = NULL;
+
+void deviceClock(clockptr msClock, clockptr usClock) {
+	clockMillis = msClock;
+	clockMicros = usClock;
+	}
@@ -0,0 +1,63 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_CLOCK_H
+#define SACN_CLOCK_H
+
+#include "Arduino.h"
+
+/*
+ * All timestamps of the library are taken from this clock, by default
+ * millis() and micros() of the board. Another clock can be injected, e.g.
+ * clock_gettime() on a host or a virtual clock for deterministic tests.
+ * The time is sampled once per update() or idle(), only the arrival times
+ * of the interpolator and the redundant receiver read the us clock per
+ * packet. Every comparison is done as a difference of uint32_t, so the
+ * wrap around is no problem.
+ */
+
+// same signature as millis() and micros(), so deviceClock(millis, micros) compiles on every core
+typedef unsigned long (*clockptr)();
+
+extern clockptr clockMillis;
+extern clockptr clockMicros;
+
+/**
+ * @brief Set the clock of the library
+ * 
+ * @param msClock function which returns the time in ms, NULL for the board clock
+ * @param usClock function which returns the time in us, NULL for millis * 1000 with an own ms clock or the board clock
+ */
+void deviceClock(clockptr msClock, clockptr usClock = NULL);
+
+/**
+ * @brief Get the time of the library clock
+ * 
+ * @return uint32_t time in ms
+ */
+inline uint32_t deviceMillis() {
+	return clockMillis != NULL ? clockMillis() : millis();
+	}
+
+/**
+ * @brief Get the time of the library clock
+ * 
+ * @return uint32_t time in us
+ */
+inline uint32_t deviceMicros() {
+	if(clockMicros != NULL) return clockMicros();
+	return clockMillis != NULL ? clockMillis() * 1000 : micros();
+	}
+
+#endif
@@ -0,0 +1,146 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNCurve.h"
+
+#define CURVE_CUSTOM 0xFF
+
+Curve::Curve(uint16_t slots, uint8_t bits) {
+	if(slots == 0 || slots > DMX_SLOTS_MAX) slots = DMX_SLOTS_MAX;
+	this->slots = slots;
+	input = new uint8_t [slots];
+	tableIndex = new uint8_t [slots];
+	memset(input, 0, slots);
+	memset(tableIndex, 0, slots);
+	result = NULL;
+	result8 = NULL;
+	if(bits == 8) {
+		result8 = new uint8_t [slots];
+		memset(result8, 0, slots);
+		}
+	else {
+		result = new uint16_t [slots];
+		memset(result, 0, slots * sizeof(uint16_t));
+		}
+	tableCount = 0;
+	table(CURVE_LINEAR, 0); // table 0 is the default for all slots
+	}
+
+Curve::~Curve() {
+	for(uint8_t i = 0; i < tableCount; i++) {
+		if(types[i] != CURVE_CUSTOM) delete[] tables[i];
+		}
+	delete[] input;
+	delete[] tableIndex;
+	delete[] result;
+	delete[] result8;
+	}
+
+bool Curve::curve(uint16_t first, uint16_t last, uint8_t type, float gamma) {
+	if(type > CURVE_GAMMA) return false;
+	int8_t index = table(type, gamma);
+	if(index < 0) return false;
+	assign(first, last, index);
+	return true;
+	}
+
+bool Curve::curve(uint16_t first, uint16_t last, const uint16_t *table) {
+	if(table == NULL) return false;
+	int8_t index = this->table(table);
+	if(index < 0) return false;
+	assign(first, last, index);
+	return true;
+	}
+
+void Curve::apply(const uint8_t *data, uint16_t length) {
+	if(length > slots) length = slots;
+	// skip unchanged slots 4 at a time
+	uint16_t i = 0;
+	for(; i + 4 <= length; i += 4) {
+		uint32_t now, before;
+		memcpy(&now, data + i, 4);
+		memcpy(&before, input + i, 4);
+		if(now != before) lookup(data, i, i + 4);
+		}
+	if(i < length) lookup(data, i, length);
+	}
+
+uint16_t* Curve::output() {
+	return result;
+	}
+
+uint16_t Curve::output(uint16_t slot) {
+	if(slot == 0 || slot > slots) return 0;
+	if(result != NULL) return result[slot - 1];
+	return result8[slot - 1] * 257;
+	}
+
+uint8_t* Curve::dmx() {
+	return result8;
+	}
+
+int8_t Curve::table(uint8_t type, float gamma) {
+	for(uint8_t i = 0; i < tableCount; i++) {
+		if(types[i] == type && (type != CURVE_GAMMA || gammas[i] == gamma)) return i;
+		}
+	if(tableCount >= SACN_CURVE_TABLES) return -1;
+	uint16_t *values = new uint16_t [256];
+	for(uint16_t v = 0; v < 256; v++) {
+		switch(type) {
+			case CURVE_SQUARE:
+				values[v] = ((uint32_t)v * v * 65535 + 32512) / 65025;
+				break;
+			case CURVE_GAMMA:
+				values[v] = (uint16_t)(pow(v / 255.0, gamma) * 65535.0 + 0.5);
+				break;
+			default:
+				values[v] = v * 257;
+				break;
+			}
+		}
+	tables[tableCount] = values;
+	types[tableCount] = type;
+	gammas[tableCount] = gamma;
+	return tableCount++;
+	}
+
+int8_t Curve::table(const uint16_t *table) {
+	for(uint8_t i = 0; i < tableCount; i++) {
+		if(tables[i] == table) return i;
+		}
+	if(tableCount >= SACN_CURVE_TABLES) return -1;
+	tables[tableCount] = table;
+	types[tableCount] = CURVE_CUSTOM;
+	gammas[tableCount] = 0;
+	return tableCount++;
+	}
+
+void Curve::assign(uint16_t first, uint16_t last, int8_t table) {
+	if(first == 0) first = 1;
+	if(last > slots) last = slots;
+	if(first > last) return;
+	memset(tableIndex + first - 1, table, last - first + 1);
+	// the output follows the new curve without new data
+	lookup(input, first - 1, last);
+	}
+
+void Curve::lookup(const uint8_t *data, uint16_t first, uint16_t last) {
+	if(result != NULL) {
+		for(uint16_t i = first; i < last; i++) result[i] = tables[tableIndex[i]][data[i]];
+		}
+	else {
+		for(uint16_t i = first; i < last; i++) result8[i] = tables[tableIndex[i]][data[i]] >> 8;
+		}
+	if(data != input) memcpy(input + first, data + first, last - first);
+	}
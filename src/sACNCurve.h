@@ -0,0 +1,118 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_CURVE_H
+#define SACN_CURVE_H
+
+#include "Arduino.h"
+#include "sACNDefs.h"
+
+// built in response curves
+#define CURVE_LINEAR 0
+#define CURVE_SQUARE 1 // square law dimmer curve
+#define CURVE_GAMMA  2
+
+/**
+ * @brief Response curve stage with lookup tables per slot
+ * 
+ * Every slot uses one of up to SACN_CURVE_TABLES lookup tables with 256 16 bit
+ * values, the tables are calculated once when a curve is set. Only changed
+ * slots are looked up again, unchanged slots are skipped 4 at a time.
+ */
+class Curve {
+	public:
+	/**
+	 * @brief Construct a new Curve object, all slots are linear
+	 * 
+	 * @param slots number of DMX slots 1...512
+	 * @param bits output resolution 8 or 16 bit
+	 */
+	Curve(uint16_t slots = DMX_SLOTS_MAX, uint8_t bits = 16);
+
+	/**
+	 * @brief Destroy the Curve object
+	 * 
+	 */
+	~Curve();
+
+	/**
+	 * @brief Set a built in curve for a range of slots
+	 * 
+	 * @param first first DMX slot 1...512
+	 * @param last last DMX slot 1...512
+	 * @param type CURVE_LINEAR, CURVE_SQUARE or CURVE_GAMMA
+	 * @param gamma gamma value for CURVE_GAMMA
+	 * @return true if the curve is set
+	 * @return false if there is no free lookup table
+	 */
+	bool curve(uint16_t first, uint16_t last, uint8_t type, float gamma = 2.2);
+
+	/**
+	 * @brief Set a custom curve for a range of slots
+	 * 
+	 * @param first first DMX slot 1...512
+	 * @param last last DMX slot 1...512
+	 * @param table lookup table with 256 16 bit values, must valid while it is used
+	 * @return true if the curve is set
+	 * @return false if there is no free lookup table
+	 */
+	bool curve(uint16_t first, uint16_t last, const uint16_t *table);
+
+	/**
+	 * @brief Apply the curves to the changed slots, called by the receiver on changed DMX data
+	 * 
+	 * @param data DMX data
+	 * @param length number of DMX slots
+	 */
+	void apply(const uint8_t *data, uint16_t length);
+
+	/**
+	 * @brief Get the 16 bit output
+	 * 
+	 * @return uint16_t* 16 bit output, NULL with 8 bit resolution
+	 */
+	uint16_t* output();
+
+	/**
+	 * @brief Get a single output slot
+	 * 
+	 * @param slot DMX slot 1...512
+	 * @return uint16_t 16 bit output value, also with 8 bit resolution
+	 */
+	uint16_t output(uint16_t slot);
+
+	/**
+	 * @brief Get the 8 bit output
+	 * 
+	 * @return uint8_t* 8 bit output, NULL with 16 bit resolution
+	 */
+	uint8_t* dmx();
+
+	private:
+	int8_t table(uint8_t type, float gamma);
+	int8_t table(const uint16_t *table);
+	void assign(uint16_t first, uint16_t last, int8_t table);
+	void lookup(const uint8_t *data, uint16_t first, uint16_t last);
+	uint16_t slots;
+	uint8_t *input;
+	uint8_t *tableIndex;
+	uint16_t *result;
+	uint8_t *result8;
+	const uint16_t *tables[SACN_CURVE_TABLES];
+	uint8_t types[SACN_CURVE_TABLES];
+	float gammas[SACN_CURVE_TABLES];
+	uint8_t tableCount;
+	};
+
+#endif
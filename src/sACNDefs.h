@@ -52,6 +52,70 @@
 // timing constants for extensions
 #define SACN_POLLING_TIME    800 // 800 ms initialize 3 times in 1 s
 #define SACN_POLLING_TIME_DD 800 // 800 ms initialize and on change 3 times in 1 s
+#define SACN_DESTINATIONS    32  // max unicast destinations per source
+#define SACN_STARTCODES      4   // alternate start codes with a handler per receiver
+
+// multicast subscription manager
+#define SACN_SUBSCRIPTION_MAX      64   // universes per subscription by default
+#define SACN_SUBSCRIPTION_IDLE     5000 // ms without data before a group is left
+#define SACN_SUBSCRIPTION_PROBE    1500 // ms a group without any data is probed, sources send at least every second
+#define SACN_SUBSCRIPTION_INTERVAL 1000 // ms between join management runs
+
+// source table
+#define SACN_SOURCE_TABLE_SOURCES 4   // tracked sources per universe
+#define SACN_SOURCE_TABLE_CIDS    256 // interned CIDs by default
+#define SACN_SEQ_WINDOW           20  // sequence numbers behind the last one are rejected
+
+// timer wheel, 3 levels of 32 slots with 4 ms resolution cover 131 s
+#define SACN_TIMER_RESOLUTION 4 // ms per tick
+#define SACN_TIMER_BITS       5 // slots per level as power of 2
+#define SACN_TIMER_LEVELS     3
+#define SACN_FRAMERATE_TIME   1000 // ms window for the framerate
+
+// virtual network
+#define SACN_VIRTUAL_PACKETS 256 // packets in flight
+#define SACN_VIRTUAL_QUEUE   32  // receive queue of a socket, like the buffer of an Ethernet chip
+#define SACN_VIRTUAL_GROUPS  8   // multicast groups per socket
+#define SACN_VIRTUAL_PATHS   16  // paths with own loss, duplication, reordering and delay
+
+// load generator
+#define SACN_LOAD_BURST 64 // max packets per update() of the load generator
+
+// frame interpolation
+#define SACN_INTERPOLATION_SPAN     22727  // us between two frames at 44 fps, used before the framerate is known
+#define SACN_INTERPOLATION_SPAN_MAX 250000 // us, longer gaps are interpolated with this span
+
+// effects engine
+#define SACN_EFFECTS 8 // effects per engine by default
+
+// response curves
+#define SACN_CURVE_TABLES 8 // lookup tables per curve stage, 512 bytes each
+
+// snapshot persistence
+#define SACN_SNAPSHOT_SLOTS    4     // slots for wear leveling
+#if defined(ESP32) || defined(ESP8266) || defined(ARDUINO_ARCH_RP2040)
+#define SACN_SNAPSHOT_INTERVAL 600000 // the emulated EEPROM erases a whole flash sector for every snapshot
+#else
+#define SACN_SNAPSHOT_INTERVAL 60000 // ms between snapshots of changed data
+#endif
+
+// shared memory table
+#define SACN_SHARED_NAME "/sACN" // POSIX shared memory object of the table
+
+// frame assembler
+#define SACN_ASSEMBLER_MAX    32 // universes per assembler by default
+#define SACN_ASSEMBLER_GROUPS 4  // sources with frames at the same time
+#define SACN_ASSEMBLER_WINDOW 10 // ms after the first universe until an incomplete frame is finished
+
+// redundant receive
+#define SACN_REDUNDANT_PATHS   8  // max networks per redundant receiver
+#define SACN_REDUNDANT_HISTORY 32 // packets remembered for the duplicate check
+
+// sharded receive on Linux hosts
+#define SACN_SHARD_POLL 100 // ms between the timeout checks of a worker
+
+// event loop
+#define SACN_EVENT_LOOP_MAX 512 // receivers and sources per event loop by default
 
 // sACN const values and variables
 
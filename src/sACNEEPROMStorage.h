@@ -0,0 +1,92 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_EEPROM_STORAGE_H
+#define SACN_EEPROM_STORAGE_H
+
+#include "Arduino.h"
+#include <EEPROM.h>
+#include "sACNStorage.h"
+
+/**
+ * @brief Storage in the EEPROM, on ESP and RP2040 the EEPROM is emulated in flash
+ * 
+ * Only included by sketches which use it, so the library builds on boards
+ * without an EEPROM library.
+ * 
+ * The emulated EEPROM of ESP32, ESP8266 and RP2040 is a RAM copy of one
+ * flash sector, every commit() erases and writes the whole sector whatever
+ * slot has changed. So the slots of a snapshot give no wear leveling there,
+ * and a power loss during commit() can lose all slots at once. The default
+ * snapshot interval is 10 minutes on these boards.
+ */
+class EEPROMStorage : public Storage {
+	public:
+	/**
+	 * @brief Construct a new EEPROM Storage object
+	 * 
+	 * @param size size of the storage in bytes
+	 * @param address start address inside of the EEPROM
+	 */
+	EEPROMStorage(uint32_t size, uint32_t address = 0) {
+		storageSize = size;
+		startAddress = address;
+		}
+
+	/**
+	 * @brief Begin the EEPROM, must called in setup() before the snapshot restore
+	 * 
+	 */
+	void begin() {
+#if defined(ESP32) || defined(ESP8266) || defined(ARDUINO_ARCH_RP2040)
+		EEPROM.begin(startAddress + storageSize);
+#endif
+		}
+
+	bool read(uint32_t address, uint8_t *data, uint16_t size) {
+		if(address + size > storageSize) return false;
+		for(uint16_t i = 0; i < size; i++) data[i] = EEPROM.read(startAddress + address + i);
+		return true;
+		}
+
+	bool write(uint32_t address, const uint8_t *data, uint16_t size) {
+		if(address + size > storageSize) return false;
+		for(uint16_t i = 0; i < size; i++) {
+#if defined(ESP32) || defined(ESP8266) || defined(ARDUINO_ARCH_RP2040)
+			EEPROM.write(startAddress + address + i, data[i]);
+#else
+			EEPROM.update(startAddress + address + i, data[i]); // only changed cells are written
+#endif
+			}
+		return true;
+		}
+
+	bool commit() {
+#if defined(ESP32) || defined(ESP8266) || defined(ARDUINO_ARCH_RP2040)
+		return EEPROM.commit();
+#else
+		return true;
+#endif
+		}
+
+	uint32_t size() {
+		return storageSize;
+		}
+
+	private:
+	uint32_t storageSize;
+	uint32_t startAddress;
+	};
+
+#endif
@@ -0,0 +1,215 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNEffects.h"
+
+// one cycle of 127.5 - 127.5 * cos(), starts and ends dark
+static const uint8_t EFFECT_SINE[256] = {
+	  0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+	 10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+	 37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+	 79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+	127, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+	176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+	218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+	245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+	255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+	245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+	218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+	176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+	128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+	 79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+	 37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+	 10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0
+	};
+
+static inline uint8_t sine(uint16_t phase) {
+	uint8_t index = phase >> 8;
+	int16_t a = EFFECT_SINE[index];
+	int16_t b = EFFECT_SINE[(uint8_t)(index + 1)];
+	return a + (((b - a) * (int16_t)(phase & 0xFF)) >> 8);
+	}
+
+static inline uint8_t triangle(uint16_t phase) {
+	return phase < 0x8000 ? phase >> 7 : (0xFFFF - phase) >> 7;
+	}
+
+Effects::Effects(uint8_t effects) {
+	effectMax = effects;
+	effectList = new Effect [effectMax];
+	for(uint8_t i = 0; i < effectMax; i++) effectList[i].source = NULL;
+	epoch = deviceMillis();
+	}
+
+Effects::~Effects() {
+	delete[] effectList;
+	}
+
+int8_t Effects::add(Source &source, uint16_t slot, uint16_t count, uint8_t type, uint16_t period, uint8_t step) {
+	if(slot == 0 || count == 0 || step == 0 || step > 4 || type > EFFECT_GRADIENT) return -1;
+	// the only range check, update() writes without checks
+	if((uint32_t)slot - 1 + (uint32_t)count * step > DMX_SLOTS_MAX) return -1;
+	for(uint8_t i = 0; i < effectMax; i++) {
+		Effect &effect = effectList[i];
+		if(effect.source != NULL) continue;
+		effect.source = &source;
+		effect.slot = slot;
+		effect.count = count;
+		effect.type = type;
+		effect.step = step;
+		effect.period = period > 0 ? period : 1;
+		effect.length = 0;
+		effect.width = 1;
+		effect.offset = 0;
+		effect.shift = 0;
+		effect.low = 0;
+		effect.range = 255;
+		effect.invert = false;
+		effect.seed = i;
+		spread(effect);
+		return i;
+		}
+	return -1;
+	}
+
+void Effects::remove(int8_t effect) {
+	if(effect < 0 || effect >= effectMax) return;
+	effectList[effect].source = NULL;
+	}
+
+void Effects::level(int8_t effect, uint8_t low, uint8_t high) {
+	if(effect < 0 || effect >= effectMax) return;
+	Effect &e = effectList[effect];
+	e.invert = low > high;
+	e.low = e.invert ? high : low;
+	e.range = e.invert ? low - high : high - low;
+	}
+
+void Effects::length(int8_t effect, uint16_t length) {
+	if(effect < 0 || effect >= effectMax) return;
+	effectList[effect].length = length;
+	spread(effectList[effect]);
+	}
+
+void Effects::width(int8_t effect, uint16_t width) {
+	if(effect < 0 || effect >= effectMax) return;
+	effectList[effect].width = width;
+	spread(effectList[effect]);
+	}
+
+void Effects::offset(int8_t effect, uint16_t phase) {
+	if(effect < 0 || effect >= effectMax) return;
+	effectList[effect].offset = phase;
+	}
+
+void Effects::shift(int8_t effect, uint16_t phase) {
+	if(effect < 0 || effect >= effectMax) return;
+	effectList[effect].shift = phase;
+	}
+
+uint8_t Effects::update() {
+	// one phase clock for all effects
+	uint32_t elapsed = deviceMillis() - epoch;
+	uint8_t rendered = 0;
+	for(uint8_t i = 0; i < effectMax; i++) {
+		if(effectList[i].source == NULL || effectList[i].source->dmx() == NULL) continue;
+		render(effectList[i], elapsed);
+		rendered++;
+		}
+	return rendered;
+	}
+
+void Effects::reset() {
+	epoch = deviceMillis();
+	}
+
+uint8_t Effects::effects() {
+	uint8_t count = 0;
+	for(uint8_t i = 0; i < effectMax; i++) {
+		if(effectList[i].source != NULL) count++;
+		}
+	return count;
+	}
+
+void Effects::spread(Effect &effect) {
+	uint16_t length = effect.length > 0 ? effect.length : effect.count;
+	// rounded up, so every length-th element starts a new cycle
+	effect.spread = (0x1000000UL + length - 1) / length;
+	uint32_t threshold = ((uint32_t)effect.width << 16) / length;
+	effect.threshold = threshold > 0xFFFF ? 0xFFFF : threshold;
+	}
+
+void Effects::render(Effect &effect, uint32_t elapsed) {
+	uint8_t *data = effect.source->dmx() + effect.slot - 1;
+	uint16_t phase = ((elapsed % effect.period) << 16) / effect.period;
+	// the effect moves to higher slots, 8 fractional bits for the spread
+	uint32_t position = (uint32_t)(uint16_t)(effect.offset - phase) << 8;
+	uint8_t low = effect.low;
+	uint16_t range = effect.range;
+	uint8_t invert = effect.invert ? 0xFF : 0x00;
+	uint8_t step = effect.step;
+	uint16_t shift = effect.shift;
+	switch(effect.type) {
+		case EFFECT_WAVE:
+			for(uint16_t i = 0; i < effect.count; i++, position += effect.spread) {
+				uint16_t p = position >> 8;
+				for(uint8_t c = 0; c < step; c++, p += shift) {
+					uint8_t v = sine(p) ^ invert;
+					*data++ = low + ((v * range + range) >> 8);
+					}
+				}
+			break;
+		case EFFECT_GRADIENT:
+			for(uint16_t i = 0; i < effect.count; i++, position += effect.spread) {
+				uint16_t p = position >> 8;
+				for(uint8_t c = 0; c < step; c++, p += shift) {
+					uint8_t v = triangle(p) ^ invert;
+					*data++ = low + ((v * range + range) >> 8);
+					}
+				}
+			break;
+		case EFFECT_CHASE: {
+			uint8_t on = low + (invert ? 0 : range);
+			uint8_t off = low + (invert ? range : 0);
+			for(uint16_t i = 0; i < effect.count; i++, position += effect.spread) {
+				uint16_t p = position >> 8;
+				for(uint8_t c = 0; c < step; c++, p += shift) {
+					*data++ = p < effect.threshold ? on : off;
+					}
+				}
+			break;
+			}
+		case EFFECT_NOISE: {
+			// random values per effect, slot and period, interpolated in time
+			uint32_t cell = elapsed / effect.period;
+			uint16_t fraction = phase >> 8;
+			uint16_t slot = effect.slot;
+			for(uint16_t i = 0; i < effect.count * step; i++, slot++) {
+				uint16_t a = hash(effect.seed, slot, cell);
+				uint16_t b = hash(effect.seed, slot, cell + 1);
+				uint8_t v = ((a * (256 - fraction) + b * fraction) >> 8) ^ invert;
+				*data++ = low + ((v * range + range) >> 8);
+				}
+			break;
+			}
+		}
+	}
+
+uint8_t Effects::hash(uint8_t seed, uint16_t slot, uint32_t cell) {
+	uint32_t x = cell * 0x9E3779B1UL + slot * 0x85EBCA77UL + seed * 0xC2B2AE3DUL;
+	x ^= x >> 15;
+	x *= 0x2C1B3C6DUL;
+	x ^= x >> 12;
+	return x >> 24;
+	}
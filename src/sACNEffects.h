@@ -0,0 +1,161 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_EFFECTS_H
+#define SACN_EFFECTS_H
+
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+// effect generators
+#define EFFECT_WAVE     0 // sine wave
+#define EFFECT_CHASE    1 // moving pulses
+#define EFFECT_NOISE    2 // smooth random values
+#define EFFECT_GRADIENT 3 // moving triangle ramp
+
+/**
+ * @brief Effects engine writing into the DMX data of sources
+ * 
+ * Every effect is a generator over a range of elements of a source, an
+ * element has 1...4 slots, e.g. RGB pixels. All effects use one phase clock,
+ * so effects over several universes stay in sync. The math is fixed point
+ * with a 16 bit phase, one cycle is 65536, the sine wave is a lookup table.
+ * The range is checked once when the effect is added, update() writes the
+ * values straight into the payload of the source.
+ */
+class Effects {
+	public:
+	/**
+	 * @brief Construct a new Effects object
+	 * 
+	 * @param effects maximum number of effects
+	 */
+	Effects(uint8_t effects = SACN_EFFECTS);
+
+	/**
+	 * @brief Destroy the Effects object
+	 * 
+	 */
+	~Effects();
+
+	/**
+	 * @brief Add an effect
+	 * 
+	 * @param source source with the DMX data
+	 * @param slot first DMX slot 1...512
+	 * @param count number of elements
+	 * @param type EFFECT_WAVE, EFFECT_CHASE, EFFECT_NOISE or EFFECT_GRADIENT
+	 * @param period time of one cycle in ms
+	 * @param step slots per element 1...4
+	 * @return int8_t index of the effect, -1 if the range is invalid or there is no space left
+	 */
+	int8_t add(Source &source, uint16_t slot, uint16_t count, uint8_t type, uint16_t period, uint8_t step = 1);
+
+	/**
+	 * @brief Remove an effect, the DMX data keeps the last values
+	 * 
+	 * @param effect index of the effect
+	 */
+	void remove(int8_t effect);
+
+	/**
+	 * @brief Set the output levels, low can be higher than high for an inverted effect
+	 * 
+	 * @param effect index of the effect
+	 * @param low level at the start of a cycle
+	 * @param high level in the middle of a cycle
+	 */
+	void level(int8_t effect, uint8_t low, uint8_t high);
+
+	/**
+	 * @brief Set the number of elements for one cycle, for a chase the distance of the pulses
+	 * 
+	 * @param effect index of the effect
+	 * @param length elements, 0 for all elements of the effect
+	 */
+	void length(int8_t effect, uint16_t length);
+
+	/**
+	 * @brief Set the width of the pulses of a chase
+	 * 
+	 * @param effect index of the effect
+	 * @param width elements
+	 */
+	void width(int8_t effect, uint16_t width);
+
+	/**
+	 * @brief Set the phase of the first element, e.g. to continue an effect in the next universe
+	 * 
+	 * @param effect index of the effect
+	 * @param phase phase 0...65535 for one cycle
+	 */
+	void offset(int8_t effect, uint16_t phase);
+
+	/**
+	 * @brief Set the phase between the slots of an element, e.g. 21845 for a rainbow over RGB
+	 * 
+	 * @param effect index of the effect
+	 * @param phase phase 0...65535 for one cycle
+	 */
+	void shift(int8_t effect, uint16_t phase);
+
+	/**
+	 * @brief Calculate all effects and write the values into the sources, call before send()
+	 * 
+	 * @return uint8_t number of calculated effects
+	 */
+	uint8_t update();
+
+	/**
+	 * @brief Restart the phase clock of all effects
+	 * 
+	 */
+	void reset();
+
+	/**
+	 * @brief Get the number of effects
+	 * 
+	 * @return uint8_t effects
+	 */
+	uint8_t effects();
+
+	private:
+	struct Effect {
+		Source *source;
+		uint16_t slot;
+		uint16_t count;
+		uint8_t type;
+		uint8_t step;
+		uint16_t period;
+		uint32_t spread; // phase per element with 8 fractional bits
+		uint16_t threshold; // lit part of a chase cycle
+		uint16_t length;
+		uint16_t width;
+		uint16_t offset;
+		uint16_t shift;
+		uint8_t low;
+		uint8_t range;
+		bool invert;
+		uint8_t seed; // effect index, every noise effect has its own values
+		};
+	void render(Effect &effect, uint32_t elapsed);
+	void spread(Effect &effect);
+	static uint8_t hash(uint8_t seed, uint16_t slot, uint32_t cell);
+	Effect *effectList;
+	uint8_t effectMax;
+	uint32_t epoch;
+	};
+
+#endif
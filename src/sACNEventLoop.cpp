@@ -0,0 +1,154 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNEventLoop.h"
+#include "sACNTimer.h"
+
+#if defined(__linux__)
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define EVENT_TIMER 0
+#define EVENT_BATCH 64
+
+EventLoop::EventLoop(uint16_t receivers, uint16_t sources) {
+	receiverMax = receivers;
+	sourceMax = sources;
+	receiverCount = 0;
+	sourceCount = 0;
+	this->receivers = new Receiver* [receiverMax];
+	this->sources = new Source* [sourceMax];
+	running = false;
+	armed = false;
+	timerWheel = NULL;
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.u64 = EVENT_TIMER;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event);
+	}
+
+EventLoop::~EventLoop() {
+	close(timerFd);
+	close(epollFd);
+	delete[] receivers;
+	delete[] sources;
+	}
+
+bool EventLoop::add(Receiver &receiver, SocketUDP &udp) {
+	if(receiverCount >= receiverMax || udp.fd() < 0) return false;
+	// level triggered, a socket with more than one packet wakes up again
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.u64 = receiverCount + 1;
+	if(epoll_ctl(epollFd, EPOLL_CTL_ADD, udp.fd(), &event) < 0) return false;
+	receivers[receiverCount++] = &receiver;
+	return true;
+	}
+
+bool EventLoop::add(Source &source) {
+	if(sourceCount >= sourceMax) return false;
+	sources[sourceCount++] = &source;
+	armed = false;
+	return true;
+	}
+
+void EventLoop::add(TimerWheel &wheel) {
+	timerWheel = &wheel;
+	armed = false;
+	}
+
+int EventLoop::run(int timeout) {
+	if(!armed) schedule();
+	struct epoll_event events[EVENT_BATCH];
+	int count = epoll_wait(epollFd, events, EVENT_BATCH, timeout);
+	if(count < 0) return errno == EINTR ? 0 : -1;
+	for(int i = 0; i < count; i++) {
+		if(events[i].data.u64 == EVENT_TIMER) {
+			uint64_t expirations;
+			if(read(timerFd, &expirations, sizeof(expirations)) < 0) continue;
+			timers();
+			}
+		else {
+			Receiver *receiver = receivers[events[i].data.u64 - 1];
+			bool active = receiver->source.active;
+			receiver->update();
+			// a new source needs a data loss timeout
+			if(!active && receiver->source.active) armed = false;
+			}
+		}
+	return count;
+	}
+
+void EventLoop::loop() {
+	running = true;
+	while(running) {
+		if(run() < 0) break;
+		}
+	}
+
+void EventLoop::stop() {
+	running = false;
+	}
+
+void EventLoop::timers() {
+	if(timerWheel != NULL) timerWheel->update();
+	// update() without pending data only checks the timeout
+	for(uint16_t i = 0; i < receiverCount; i++) {
+		if(receivers[i]->source.active && receivers[i]->timerWheel == NULL) receivers[i]->update();
+		}
+	for(uint16_t i = 0; i < sourceCount; i++) {
+		sources[i]->idle();
+		sources[i]->idleDD();
+		}
+	armed = false;
+	}
+
+void EventLoop::schedule() {
+	// the timer can expire too early when packets or send() moved a deadline, then it is scheduled again
+	uint32_t now = deviceMillis();
+	int32_t next = INT32_MAX;
+	for(uint16_t i = 0; i < receiverCount; i++) {
+		if(!receivers[i]->source.active || receivers[i]->timerWheel != NULL) continue;
+		int32_t delay = (int32_t)(receivers[i]->receiverTimeout + E131_NETWORK_DATA_LOSS_TIMEOUT + 1 - now);
+		if(delay < next) next = delay;
+		}
+	for(uint16_t i = 0; i < sourceCount; i++) {
+		if(sources[i]->timerWheel != NULL) continue;
+		int32_t delay = (int32_t)(sources[i]->timestamp + SACN_POLLING_TIME + 1 - now);
+		if(delay < next) next = delay;
+		if(sources[i]->priorityDD) {
+			delay = (int32_t)(sources[i]->timestampDD + SACN_POLLING_TIME_DD + 1 - now);
+			if(delay < next) next = delay;
+			}
+		}
+	if(timerWheel != NULL) {
+		int32_t delay = timerWheel->next();
+		if(delay >= 0 && delay < next) next = delay;
+		}
+	struct itimerspec spec = {};
+	if(next != INT32_MAX) {
+		if(next < 1) next = 1;
+		spec.it_value.tv_sec = next / 1000;
+		spec.it_value.tv_nsec = (next % 1000) * 1000000L;
+		}
+	timerfd_settime(timerFd, 0, &spec, NULL);
+	armed = true;
+	}
+
+#endif
@@ -0,0 +1,113 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_EVENT_LOOP_H
+#define SACN_EVENT_LOOP_H
+
+#if defined(__linux__)
+
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+#include "sACNSocketUDP.h"
+
+/**
+ * @brief Event loop for Linux hosts with epoll and timerfd
+ * 
+ * The sockets of the receivers are registered with epoll, the data loss
+ * timeouts and the keep alive times of the sources with one timerfd.
+ * Packets are only proceeded when data arrives, so there is no busy polling
+ * of update() and idle(). The callbacks of the receivers work unchanged.
+ */
+class EventLoop {
+	public:
+	/**
+	 * @brief Construct a new Event Loop object
+	 * 
+	 * @param receivers maximum number of receivers
+	 * @param sources maximum number of sources
+	 */
+	EventLoop(uint16_t receivers = SACN_EVENT_LOOP_MAX, uint16_t sources = SACN_EVENT_LOOP_MAX);
+
+	/**
+	 * @brief Destroy the Event Loop object
+	 * 
+	 */
+	~EventLoop();
+
+	/**
+	 * @brief Add a receiver, must called after begin() of the receiver
+	 * 
+	 * @param receiver receiver
+	 * @param udp socket of the receiver
+	 * @return true if added
+	 * @return false if there is no space left or on error
+	 */
+	bool add(Receiver &receiver, SocketUDP &udp);
+
+	/**
+	 * @brief Add a source for the keep alive packets, must called after begin() of the source
+	 * 
+	 * @param source source
+	 * @return true if added
+	 * @return false if there is no space left
+	 */
+	bool add(Source &source);
+
+	/**
+	 * @brief Add the timer wheel which is shared by the receivers and sources
+	 * 
+	 * @param wheel timer wheel
+	 */
+	void add(TimerWheel &wheel);
+
+	/**
+	 * @brief Wait for data and timers and proceed them
+	 * 
+	 * @param timeout max time to wait in ms, -1 waits until an event occurs
+	 * @return int number of events, -1 on error
+	 */
+	int run(int timeout = -1);
+
+	/**
+	 * @brief Run the event loop until stop() is called
+	 * 
+	 */
+	void loop();
+
+	/**
+	 * @brief Stop the event loop, can called from a callback
+	 * 
+	 */
+	void stop();
+
+	private:
+	void timers();
+	void schedule();
+	int epollFd;
+	int timerFd;
+	Receiver **receivers;
+	uint16_t receiverCount;
+	uint16_t receiverMax;
+	Source **sources;
+	uint16_t sourceCount;
+	uint16_t sourceMax;
+	TimerWheel *timerWheel;
+	bool running;
+	bool armed;
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNFrameAssembler.h"
+
+FrameAssembler::FrameAssembler(uint16_t universes) {
+	entryMax = universes;
+	entryCount = 0;
+	entries = new Entry [entryMax];
+	for(uint8_t i = 0; i < SACN_ASSEMBLER_GROUPS; i++) groups[i] = {};
+	frameWindow = SACN_ASSEMBLER_WINDOW;
+	callFrameFunction = NULL;
+	frameGroup = -1;
+	frameComplete = false;
+	frameCount = 0;
+	incompleteCount = 0;
+	}
+
+FrameAssembler::~FrameAssembler() {
+	delete[] entries;
+	}
+
+bool FrameAssembler::add(Receiver &receiver, uint16_t universe) {
+	if(entryCount >= entryMax) return false;
+	Entry &entry = entries[entryCount++];
+	entry.receiver = &receiver;
+	entry.universe = universe;
+	entry.packets = receiver.packets();
+	entry.changes = receiver.changes();
+	entry.sequence = receiver.sequence();
+	entry.frame = 0;
+	entry.group = -1;
+	entry.arrived = false;
+	return true;
+	}
+
+uint16_t FrameAssembler::add(Receiver receivers[], uint16_t universe, uint16_t count) {
+	uint16_t added = 0;
+	for(uint16_t i = 0; i < count; i++) {
+		if(add(receivers[i], universe + i)) added++;
+		}
+	return added;
+	}
+
+void FrameAssembler::window(uint32_t window) {
+	frameWindow = window;
+	}
+
+void FrameAssembler::callbackFrame(fptr callFrame) {
+	callFrameFunction = callFrame;
+	}
+
+uint8_t FrameAssembler::update() {
+	uint8_t finished = 0;
+	uint32_t now = deviceMillis();
+	for(uint16_t i = 0; i < entryCount; i++) {
+		Entry &entry = entries[i];
+		Receiver *receiver = entry.receiver;
+		uint32_t packets = receiver->packets();
+		if(!receiver->sources()) {
+			// the universe has lost its source
+			if(entry.group >= 0) leave(entry);
+			entry.packets = packets;
+			continue;
+			}
+		if(packets == entry.packets) continue;
+		entry.packets = packets;
+		int8_t index = find(receiver->cid());
+		if(index < 0) continue;
+		Group &group = groups[index];
+		uint8_t sequence = receiver->sequence();
+		if(entry.group != index) {
+			if(entry.group >= 0) leave(entry);
+			entry.group = index;
+			entry.frame = group.frame;
+			group.members++;
+			// the universes join one by one, a frame is complete after a full frame with all members
+			group.stable = false;
+			}
+		else {
+			// lost packets move the universe by more than one frame
+			entry.frame += (uint8_t)(sequence - entry.sequence);
+			}
+		entry.sequence = sequence;
+		if(group.arrived > 0) {
+			int8_t ahead = entry.frame - group.frame;
+			if(ahead > 0) {
+				// the universe sends a later frame, the current one is missing universes
+				finish(index, false);
+				finished++;
+				}
+			// a universe which sends slower, e.g. unchanged data only with the keep alive
+			else if(ahead < 0) entry.frame = group.frame;
+			}
+		if(group.arrived == 0) {
+			group.frame = entry.frame;
+			group.timestamp = now;
+			}
+		entry.arrived = true;
+		group.arrived++;
+		uint32_t changes = receiver->changes();
+		if(changes != entry.changes) {
+			entry.changes = changes;
+			group.changed = true;
+			}
+		if(group.stable && group.arrived == group.members) {
+			finish(index, true);
+			finished++;
+			}
+		}
+	// frames with missing universes are finished after the window
+	for(uint8_t i = 0; i < SACN_ASSEMBLER_GROUPS; i++) {
+		if(groups[i].arrived > 0 && (uint32_t)(now - groups[i].timestamp) >= frameWindow) {
+			finish(i, false);
+			finished++;
+			}
+		}
+	return finished;
+	}
+
+uint8_t* FrameAssembler::cid() {
+	if(frameGroup < 0) return NULL;
+	return groups[frameGroup].cid;
+	}
+
+uint16_t FrameAssembler::universes() {
+	if(frameGroup < 0) return 0;
+	return groups[frameGroup].arrived;
+	}
+
+bool FrameAssembler::contains(uint16_t universe) {
+	if(frameGroup < 0) return false;
+	for(uint16_t i = 0; i < entryCount; i++) {
+		if(entries[i].universe == universe) return entries[i].group == frameGroup && entries[i].arrived;
+		}
+	return false;
+	}
+
+bool FrameAssembler::complete() {
+	return frameComplete;
+	}
+
+uint32_t FrameAssembler::frames() {
+	return frameCount;
+	}
+
+uint32_t FrameAssembler::incomplete() {
+	return incompleteCount;
+	}
+
+int8_t FrameAssembler::find(const uint8_t *cid) {
+	int8_t free = -1;
+	for(uint8_t i = 0; i < SACN_ASSEMBLER_GROUPS; i++) {
+		if(groups[i].members == 0) {
+			if(free < 0) free = i;
+			continue;
+			}
+		if(memcmp(groups[i].cid, cid, CID_SIZE) == 0) return i;
+		}
+	if(free >= 0) {
+		groups[free] = {};
+		memcpy(groups[free].cid, cid, CID_SIZE);
+		}
+	return free;
+	}
+
+void FrameAssembler::leave(Entry &entry) {
+	Group &group = groups[entry.group];
+	if(entry.arrived) group.arrived--;
+	group.members--;
+	group.stable = false;
+	entry.group = -1;
+	entry.arrived = false;
+	}
+
+void FrameAssembler::finish(int8_t group, bool complete) {
+	frameCount++;
+	if(!complete) incompleteCount++;
+	if(groups[group].changed && callFrameFunction != NULL) {
+		frameGroup = group;
+		frameComplete = complete;
+		callFrameFunction();
+		frameGroup = -1;
+		}
+	for(uint16_t i = 0; i < entryCount; i++) {
+		if(entries[i].group == group) entries[i].arrived = false;
+		}
+	groups[group].arrived = 0;
+	groups[group].changed = false;
+	groups[group].stable = true;
+	}
@@ -0,0 +1,173 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_FRAME_ASSEMBLER_H
+#define SACN_FRAME_ASSEMBLER_H
+
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+/**
+ * @brief Groups universes of the same source into frames without sync packets
+ * 
+ * The universes of a source are a group. A frame starts with the first
+ * packet of a universe of the group and is complete when every universe of
+ * the group has sent a packet. The sequence number of every universe tells
+ * which frame a packet belongs to, if a universe sends a later frame
+ * before, e.g. after a lost packet, or the frame window expires, the frame
+ * is finished incomplete. The universes join a group with their first
+ * packet, so the first frame after a universe joins or leaves is never
+ * complete. A packet with another start code, e.g. 0xDD, uses a sequence
+ * number too and is seen like a lost packet. There is one callback per
+ * frame with changed data instead of one per universe.
+ */
+class FrameAssembler {
+	typedef void (*fptr)();
+	public:
+	/**
+	 * @brief Construct a new Frame Assembler object
+	 * 
+	 * @param universes maximum number of universes
+	 */
+	FrameAssembler(uint16_t universes = SACN_ASSEMBLER_MAX);
+
+	/**
+	 * @brief Destroy the Frame Assembler object
+	 * 
+	 */
+	~FrameAssembler();
+
+	/**
+	 * @brief Add the receiver of a universe
+	 * 
+	 * @param receiver receiver for the universe
+	 * @param universe DMX universe of the receiver
+	 * @return true if the universe is added
+	 * @return false if there is no space left
+	 */
+	bool add(Receiver &receiver, uint16_t universe);
+
+	/**
+	 * @brief Add an array of receivers for a range of universes
+	 * 
+	 * @param receivers array of receivers
+	 * @param universe first DMX universe of the range
+	 * @param count number of universes
+	 * @return uint16_t number of added universes
+	 */
+	uint16_t add(Receiver receivers[], uint16_t universe, uint16_t count);
+
+	/**
+	 * @brief Set the frame window
+	 * 
+	 * @param window time in ms after the first universe until an incomplete frame is finished
+	 */
+	void window(uint32_t window);
+
+	/**
+	 * @brief Callback for a frame with changed data
+	 * 
+	 * @param callFrame function name to call
+	 */
+	void callbackFrame(fptr callFrame);
+
+	/**
+	 * @brief Check the receivers for new packets, must inside of loop() after the receivers
+	 * 
+	 * @return uint8_t number of finished frames
+	 */
+	uint8_t update();
+
+	/**
+	 * @brief Get the CID of the source of the frame, inside of the callback
+	 * 
+	 * @return uint8_t* source CID
+	 */
+	uint8_t* cid();
+
+	/**
+	 * @brief Get the number of universes of the frame, inside of the callback
+	 * 
+	 * @return uint16_t universes
+	 */
+	uint16_t universes();
+
+	/**
+	 * @brief Check if a universe is part of the frame, inside of the callback
+	 * 
+	 * @param universe DMX universe
+	 * @return true if the universe has sent a packet for the frame
+	 * @return false if not
+	 */
+	bool contains(uint16_t universe);
+
+	/**
+	 * @brief Check if the frame is complete, inside of the callback
+	 * 
+	 * @return true if every universe of the source has sent a packet
+	 * @return false if the frame was finished by the window or a later frame of a universe
+	 */
+	bool complete();
+
+	/**
+	 * @brief Get the number of finished frames
+	 * 
+	 * @return uint32_t frames
+	 */
+	uint32_t frames();
+
+	/**
+	 * @brief Get the number of incomplete frames
+	 * 
+	 * @return uint32_t frames
+	 */
+	uint32_t incomplete();
+
+	private:
+	struct Entry {
+		Receiver *receiver;
+		uint16_t universe;
+		uint32_t packets;
+		uint32_t changes;
+		uint8_t sequence;
+		uint8_t frame;
+		int8_t group;
+		bool arrived;
+		};
+	struct Group {
+		uint8_t cid[16];
+		uint16_t members;
+		uint16_t arrived;
+		uint32_t timestamp;
+		uint8_t frame;
+		bool changed;
+		bool stable;
+		};
+	int8_t find(const uint8_t *cid);
+	void leave(Entry &entry);
+	void finish(int8_t group, bool complete);
+	Entry *entries;
+	uint16_t entryCount;
+	uint16_t entryMax;
+	Group groups[SACN_ASSEMBLER_GROUPS];
+	uint32_t frameWindow;
+	fptr callFrameFunction;
+	int8_t frameGroup;
+	bool frameComplete;
+	uint32_t frameCount;
+	uint32_t incompleteCount;
+	};
+
+#endif
@@ -0,0 +1,129 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNInterpolator.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+Interpolator::Interpolator(uint16_t slots) {
+	if(slots == 0 || slots > DMX_SLOTS_MAX) slots = DMX_SLOTS_MAX;
+	this->slots = slots;
+	start = new uint16_t [slots];
+	target = new uint16_t [slots];
+	result = new uint16_t [slots];
+	memset(start, 0, slots * sizeof(uint16_t));
+	memset(target, 0, slots * sizeof(uint16_t));
+	memset(result, 0, slots * sizeof(uint16_t));
+	targetTime = 0;
+	frameSpan = SACN_INTERPOLATION_SPAN;
+	fixedSpan = 0;
+	valid = false;
+	}
+
+Interpolator::~Interpolator() {
+	delete[] start;
+	delete[] target;
+	delete[] result;
+	}
+
+void Interpolator::frame(const uint8_t *data, uint16_t length, uint32_t time, uint8_t framerate) {
+	if(length > slots) length = slots;
+	if(valid) {
+		// continue from the current output value
+		output(start, time);
+		if(framerate > 0) frameSpan = 1000000UL / framerate;
+		else frameSpan = (uint32_t)(time - targetTime);
+		if(frameSpan == 0) frameSpan = 1;
+		if(frameSpan > SACN_INTERPOLATION_SPAN_MAX) frameSpan = SACN_INTERPOLATION_SPAN_MAX;
+		}
+	else {
+		// the first frame is the start and the target
+		for(uint16_t i = 0; i < length; i++) start[i] = data[i] * 257;
+		valid = true;
+		}
+	for(uint16_t i = 0; i < length; i++) target[i] = data[i] * 257;
+	targetTime = time;
+	}
+
+uint16_t* Interpolator::output() {
+	output(result, deviceMicros());
+	return result;
+	}
+
+void Interpolator::output(uint16_t *data, uint32_t time) {
+	uint32_t f = fraction(time);
+	if(f == 0) memmove(data, start, slots * sizeof(uint16_t));
+	else if(f >= 65536) memmove(data, target, slots * sizeof(uint16_t));
+	else lerp(data, start, target, slots, f);
+	}
+
+uint16_t Interpolator::output(uint16_t slot) {
+	if(slot > 0 && slot <= slots) return result[slot - 1];
+	return 0;
+	}
+
+void Interpolator::span(uint32_t span) {
+	fixedSpan = span;
+	}
+
+uint32_t Interpolator::span() {
+	if(fixedSpan > 0) return fixedSpan;
+	return frameSpan;
+	}
+
+uint32_t Interpolator::fraction(uint32_t time) {
+	// timestamps before the arrival of the frame are in the past and clamped
+	int32_t elapsed = (int32_t)(time - targetTime);
+	uint32_t duration = span();
+	if(elapsed <= 0) return 0;
+	if((uint32_t)elapsed >= duration) return 65536;
+	return (uint32_t)(((uint64_t)elapsed << 16) / duration);
+	}
+
+/*
+ * start * (1 - f) + target * f with f in 1/65536, the two products are
+ * truncated separately, so the result never overflows and the scalar and
+ * vector kernels are bit exact
+ */
+void Interpolator::lerp(uint16_t *data, const uint16_t *start, const uint16_t *target, uint16_t slots, uint16_t fraction) {
+	uint16_t inverse = 65536 - fraction;
+	uint16_t i = 0;
+#if defined(__SSE2__)
+	__m128i f = _mm_set1_epi16((int16_t)fraction);
+	__m128i g = _mm_set1_epi16((int16_t)inverse);
+	for(; i + 8 <= slots; i += 8) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(start + i));
+		__m128i t = _mm_loadu_si128((const __m128i*)(target + i));
+		__m128i d = _mm_add_epi16(_mm_mulhi_epu16(s, g), _mm_mulhi_epu16(t, f));
+		_mm_storeu_si128((__m128i*)(data + i), d);
+		}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	uint16x4_t f = vdup_n_u16(fraction);
+	uint16x4_t g = vdup_n_u16(inverse);
+	for(; i + 8 <= slots; i += 8) {
+		uint16x8_t s = vld1q_u16(start + i);
+		uint16x8_t t = vld1q_u16(target + i);
+		uint16x4_t low = vadd_u16(vshrn_n_u32(vmull_u16(vget_low_u16(s), g), 16), vshrn_n_u32(vmull_u16(vget_low_u16(t), f), 16));
+		uint16x4_t high = vadd_u16(vshrn_n_u32(vmull_u16(vget_high_u16(s), g), 16), vshrn_n_u32(vmull_u16(vget_high_u16(t), f), 16));
+		vst1q_u16(data + i, vcombine_u16(low, high));
+		}
+#endif
+	for(; i < slots; i++) {
+		data[i] = (uint16_t)((((uint32_t)start[i] * inverse) >> 16) + (((uint32_t)target[i] * fraction) >> 16));
+		}
+	}
@@ -0,0 +1,106 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_INTERPOLATOR_H
+#define SACN_INTERPOLATOR_H
+
+#include "Arduino.h"
+#include "sACNDefs.h"
+#include "sACNClock.h"
+
+/**
+ * @brief Frame interpolation for outputs with a higher refresh rate than sACN
+ * 
+ * The interpolator keeps the start and the target frame as 16 bit values
+ * with the arrival timestamp of the target. An output frame is the linear interpolation
+ * between both over one frame span, the span is taken from the framerate of
+ * the receiver. A new frame starts at the current output value, so early or
+ * late frames do not step. Timestamps are in us.
+ */
+class Interpolator {
+	public:
+	/**
+	 * @brief Construct a new Interpolator object
+	 * 
+	 * @param slots number of DMX slots 1...512
+	 */
+	Interpolator(uint16_t slots = DMX_SLOTS_MAX);
+
+	/**
+	 * @brief Destroy the Interpolator object
+	 * 
+	 */
+	~Interpolator();
+
+	/**
+	 * @brief Set a new target frame, called by the receiver for every valid packet
+	 * 
+	 * @param data DMX data
+	 * @param length number of DMX slots
+	 * @param time arrival timestamp in us
+	 * @param framerate framerate of the source, 0 if unknown
+	 */
+	void frame(const uint8_t *data, uint16_t length, uint32_t time, uint8_t framerate = 0);
+
+	/**
+	 * @brief Calculate the output frame for now
+	 * 
+	 * @return uint16_t* 16 bit output frame
+	 */
+	uint16_t* output();
+
+	/**
+	 * @brief Calculate an output frame
+	 * 
+	 * @param data buffer for the 16 bit output frame
+	 * @param time timestamp of the output frame in us
+	 */
+	void output(uint16_t *data, uint32_t time);
+
+	/**
+	 * @brief Get a single slot of the last output frame
+	 * 
+	 * @param slot DMX slot 1...512
+	 * @return uint16_t 16 bit output value
+	 */
+	uint16_t output(uint16_t slot);
+
+	/**
+	 * @brief Set a fixed interpolation span
+	 * 
+	 * @param span span in us, 0 for the span of the framerate
+	 */
+	void span(uint32_t span);
+
+	/**
+	 * @brief Get the current interpolation span
+	 * 
+	 * @return uint32_t span in us
+	 */
+	uint32_t span();
+
+	private:
+	uint32_t fraction(uint32_t time);
+	static void lerp(uint16_t *data, const uint16_t *start, const uint16_t *target, uint16_t slots, uint16_t fraction);
+	uint16_t slots;
+	uint16_t *start;
+	uint16_t *target;
+	uint16_t *result;
+	uint32_t targetTime;
+	uint32_t frameSpan;
+	uint32_t fixedSpan;
+	bool valid;
+	};
+
+#endif
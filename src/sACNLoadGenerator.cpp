@@ -0,0 +1,221 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNLoadGenerator.h"
+
+extern uint8_t globalCID[16];
+extern char globalName[64];
+
+LoadGenerator::LoadGenerator(UDP &udp, uint16_t universe, uint16_t universes, uint8_t sources) {
+	this->udp = &udp;
+	this->universe = universe;
+	this->universes = universes;
+	this->sources = sources;
+	streamCount = (uint32_t)universes * sources;
+	streams = new Stream [streamCount];
+	sacnPacket = new uint8_t [SACN_BUFFER_MAX];
+	running = false;
+	unicastMode = false;
+	framerate = 44;
+	basePriority = PRIORITY_STANDARD;
+	priorityStep = 0;
+	changeRate = 1000;
+	terminateRate = 0;
+	malformedRate = 0;
+	malformedBranches = MALFORMED_ALL;
+	malformedNext = 0;
+	seed = 1;
+	}
+
+LoadGenerator::~LoadGenerator() {
+	delete[] streams;
+	delete[] sacnPacket;
+	}
+
+void LoadGenerator::begin(uint16_t framerate) {
+	this->framerate = framerate;
+	memset(streams, 0, sizeof(Stream) * streamCount);
+	Source::initPacket(sacnPacket, universe, basePriority, globalCID, globalName);
+	udp->begin(ACN_SDT_MULTICAST_PORT);
+	sentCount = 0;
+	changedCount = 0;
+	terminatedCount = 0;
+	memset(malformedCount, 0, sizeof(malformedCount));
+	streamNext = 0;
+	scheduled = 0;
+	startTimestamp = deviceMillis();
+	running = true;
+	}
+
+void LoadGenerator::begin(IPAddress ip, uint16_t framerate) {
+	this->ip = ip;
+	unicastMode = true;
+	begin(framerate);
+	}
+
+void LoadGenerator::stop() {
+	running = false;
+	udp->stop();
+	}
+
+uint16_t LoadGenerator::update() {
+	if(!running) return 0;
+	uint32_t elapsed = deviceMillis() - startTimestamp;
+	uint64_t due = (uint64_t)elapsed * framerate * streamCount / 1000;
+	uint16_t count = 0;
+	// a limited burst keeps loop() alive when the socket can't reach the rate
+	while(scheduled < due && count < SACN_LOAD_BURST) {
+		send(streamNext);
+		streamNext++;
+		if(streamNext >= streamCount) streamNext = 0;
+		scheduled++;
+		count++;
+		}
+	return count;
+	}
+
+void LoadGenerator::priority(uint8_t priority, uint8_t step) {
+	basePriority = priority;
+	priorityStep = step;
+	}
+
+void LoadGenerator::change(uint16_t permille) {
+	changeRate = permille;
+	}
+
+void LoadGenerator::terminate(uint16_t permille) {
+	terminateRate = permille;
+	}
+
+void LoadGenerator::malformed(uint16_t permille, uint32_t branches) {
+	malformedRate = permille;
+	malformedBranches = branches & MALFORMED_ALL;
+	}
+
+uint32_t LoadGenerator::sent() {
+	return sentCount;
+	}
+
+uint32_t LoadGenerator::changed() {
+	return changedCount;
+	}
+
+uint32_t LoadGenerator::terminated() {
+	return terminatedCount;
+	}
+
+uint32_t LoadGenerator::malformed() {
+	uint32_t count = 0;
+	for(uint8_t i = 0; i < MALFORMED_BRANCHES; i++) count += malformedCount[i];
+	return count;
+	}
+
+uint32_t LoadGenerator::malformedBranch(uint8_t branch) {
+	if(branch >= MALFORMED_BRANCHES) return 0;
+	return malformedCount[branch];
+	}
+
+void LoadGenerator::send(uint32_t stream) {
+	Stream &state = streams[stream];
+	uint16_t packetUniverse = universe + stream / sources;
+	uint8_t source = stream % sources;
+	uint16_t priority = basePriority + source * priorityStep;
+	if(priority > PRIORITY_MAX) priority = PRIORITY_MAX;
+	// patch the template
+	sacnPacket[CID_ADDR + CID_SIZE - 1] = globalCID[CID_SIZE - 1] ^ source;
+	sacnPacket[PRIORITY_ADDR] = priority;
+	sacnPacket[UNIVERSE_ADDR] = packetUniverse >> 8;
+	sacnPacket[UNIVERSE_ADDR + 1] = packetUniverse;
+	sacnPacket[OPTIONS_ADDR] = 0;
+	if(state.terminate == 0 && chance(terminateRate)) {
+		state.terminate = 3;
+		terminatedCount++;
+		}
+	if(state.terminate > 0) {
+		sacnPacket[OPTIONS_ADDR] = STREAM_TERMINATED;
+		state.terminate--;
+		}
+	if(chance(changeRate)) {
+		state.level++;
+		changedCount++;
+		}
+	for(uint16_t i = 0; i < DMX_SLOTS_MAX; i++) {
+		sacnPacket[DMX_VALUES_ADDR + i] = state.level + i;
+		}
+	bool broken = malformedBranches != 0 && chance(malformedRate);
+	if(broken) {
+		// the branches of the mask are used in turn
+		while((malformedBranches & (1UL << malformedNext)) == 0) {
+			malformedNext = (malformedNext + 1) % MALFORMED_BRANCHES;
+			}
+		corrupt(malformedNext, state);
+		malformedCount[malformedNext]++;
+		malformedNext = (malformedNext + 1) % MALFORMED_BRANCHES;
+		}
+	else {
+		sacnPacket[SEQ_NUM_ADDR] = state.seqNumber++;
+		}
+	if(unicastMode) {
+		udp->beginPacket(ip, ACN_SDT_MULTICAST_PORT);
+		}
+	else {
+		uint8_t mcastIP[4] = {239, 255, 0, 0};
+		mcastIP[2] = packetUniverse >> 8;
+		mcastIP[3] = packetUniverse;
+		udp->beginPacket(mcastIP, ACN_SDT_MULTICAST_PORT);
+		}
+	udp->write(sacnPacket, SACN_BUFFER_MAX);
+	udp->endPacket();
+	sentCount++;
+	// restore the template
+	if(broken) Source::initPacket(sacnPacket, universe, basePriority, globalCID, globalName);
+	}
+
+void LoadGenerator::corrupt(uint8_t branch, Stream &state) {
+	sacnPacket[SEQ_NUM_ADDR] = state.seqNumber;
+	switch(branch) {
+		case MALFORMED_PREAMBLE: sacnPacket[PREAMBLE_ADDR + 1] = 0xFF; break;
+		case MALFORMED_POSTAMBLE: sacnPacket[POSTAMBLE_ADDR] = 0x01; break;
+		case MALFORMED_IDENTIFIER: sacnPacket[ACN_IDENTIFIER_ADDR] = 'X'; break;
+		case MALFORMED_ROOT_LENGTH: sacnPacket[ROOT_FLAGS_AND_LENGTH_ADDR + 1]--; break;
+		case MALFORMED_ROOT_VECTOR: sacnPacket[VECTOR_ROOT_E131_DATA_ADDR + 3] = 0x08; break;
+		case MALFORMED_FRAMING_LENGTH: sacnPacket[FRAMING_FLAGS_AND_LENGTH_ADDR + 1]--; break;
+		case MALFORMED_FRAMING_VECTOR: sacnPacket[VECTOR_E131_DATA_PACKET_ADDR + 3] = 0x01; break;
+		case MALFORMED_PRIORITY: sacnPacket[PRIORITY_ADDR] = PRIORITY_MAX + 1; break;
+		case MALFORMED_OPTIONS: sacnPacket[OPTIONS_ADDR] = PREVIEW_DATA; break;
+		case MALFORMED_UNIVERSE: sacnPacket[UNIVERSE_ADDR + 1]++; break;
+		case MALFORMED_DMP_LENGTH: sacnPacket[DMP_FLAGS_AND_LENGTH_ADDR + 1]--; break;
+		case MALFORMED_DMP_VECTOR: sacnPacket[VECTOR_DMP_SET_PROPERTY_ADDR] = 0x01; break;
+		case MALFORMED_ADDRESS_TYPE: sacnPacket[DMP_ADDRESS_AND_DATA_ADDR] = 0xA2; break;
+		case MALFORMED_FIRST_ADDRESS: sacnPacket[FIRST_PROPERTY_ADDRESS_ADDR + 1] = 0x01; break;
+		case MALFORMED_ADDRESS_INC: sacnPacket[ADDRESS_INC_ADDR + 1] = 0x02; break;
+		case MALFORMED_PROPERTY_COUNT: sacnPacket[PROPERTY_VALUE_COUNT_ADDR + 1]--; break;
+		case MALFORMED_STARTCODE: sacnPacket[STARTCODE_ADDR] = 0xFF; break;
+		case MALFORMED_SEQUENCE: sacnPacket[SEQ_NUM_ADDR] = state.seqNumber - 2; break;
+		}
+	}
+
+uint32_t LoadGenerator::random() {
+	// xorshift32
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+	}
+
+bool LoadGenerator::chance(uint16_t permille) {
+	if(permille == 0) return false;
+	if(permille >= 1000) return true;
+	return (random() % 1000) < permille;
+	}
@@ -0,0 +1,183 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_LOAD_GENERATOR_H
+#define SACN_LOAD_GENERATOR_H
+
+#include "Arduino.h"
+#include "Udp.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+// malformed packets, one for each reject branch of the receiver
+#define MALFORMED_PREAMBLE        0
+#define MALFORMED_POSTAMBLE       1
+#define MALFORMED_IDENTIFIER      2
+#define MALFORMED_ROOT_LENGTH     3
+#define MALFORMED_ROOT_VECTOR     4
+#define MALFORMED_FRAMING_LENGTH  5
+#define MALFORMED_FRAMING_VECTOR  6
+#define MALFORMED_PRIORITY        7
+#define MALFORMED_OPTIONS         8
+#define MALFORMED_UNIVERSE        9
+#define MALFORMED_DMP_LENGTH      10
+#define MALFORMED_DMP_VECTOR      11
+#define MALFORMED_ADDRESS_TYPE    12
+#define MALFORMED_FIRST_ADDRESS   13
+#define MALFORMED_ADDRESS_INC     14
+#define MALFORMED_PROPERTY_COUNT  15
+#define MALFORMED_STARTCODE       16 // unassigned start code 0xFF
+#define MALFORMED_SEQUENCE        17
+#define MALFORMED_BRANCHES        18
+#define MALFORMED_ALL             0x3FFFF
+
+/**
+ * @brief Synthetic sACN load for stress testing of receivers
+ * 
+ * Sends N universes x M sources at a target framerate over any UDP socket.
+ * The packets are built from one template by Source::initPacket(), only the
+ * CID, priority, universe, sequence number and the payload are patched.
+ */
+class LoadGenerator {
+	public:
+	/**
+	 * @brief Construct a new Load Generator object
+	 * 
+	 * @param udp socket for sending
+	 * @param universe first DMX universe
+	 * @param universes number of universes
+	 * @param sources number of sources per universe
+	 */
+	LoadGenerator(UDP &udp, uint16_t universe, uint16_t universes, uint8_t sources = 1);
+
+	/**
+	 * @brief Destroy the Load Generator object
+	 * 
+	 */
+	~LoadGenerator();
+
+	/**
+	 * @brief Start sending
+	 * 
+	 * @param framerate packets per second for each universe and source
+	 */
+	void begin(uint16_t framerate = 44);
+
+	/**
+	 * @brief Send to a unicast address instead of the multicast groups
+	 * 
+	 * @param ip unicast address
+	 */
+	void begin(IPAddress ip, uint16_t framerate = 44);
+
+	/**
+	 * @brief Stop sending
+	 * 
+	 */
+	void stop();
+
+	/**
+	 * @brief Send all due packets, must inside of loop()
+	 * 
+	 * @return uint16_t number of sent packets
+	 */
+	uint16_t update();
+
+	/**
+	 * @brief Set the priority mix, source n gets priority + n * step
+	 * 
+	 * @param priority priority of the first source
+	 * @param step priority difference between the sources
+	 */
+	void priority(uint8_t priority, uint8_t step = 0);
+
+	/**
+	 * @brief Set the payload change rate
+	 * 
+	 * @param permille packets with changed payload per 1000
+	 */
+	void change(uint16_t permille);
+
+	/**
+	 * @brief Set the termination rate, a terminated stream sends 3 packets with the terminated flag
+	 * 
+	 * @param permille terminated streams per 1000 packets
+	 */
+	void terminate(uint16_t permille);
+
+	/**
+	 * @brief Set the rate of malformed packets
+	 * 
+	 * @param permille malformed packets per 1000
+	 * @param branches bit mask of the MALFORMED_ branches, they are used in turn
+	 */
+	void malformed(uint16_t permille, uint32_t branches = MALFORMED_ALL);
+
+	/**
+	 * @brief Get the statistics
+	 * 
+	 * @return uint32_t number of packets
+	 */
+	uint32_t sent();
+	uint32_t changed();
+	uint32_t terminated();
+	uint32_t malformed();
+
+	/**
+	 * @brief Get the number of malformed packets of a branch
+	 * 
+	 * @param branch MALFORMED_ branch
+	 * @return uint32_t number of packets
+	 */
+	uint32_t malformedBranch(uint8_t branch);
+
+	private:
+	struct Stream {
+		uint8_t seqNumber;
+		uint8_t level;
+		uint8_t terminate;
+		};
+	void send(uint32_t stream);
+	void corrupt(uint8_t branch, Stream &state);
+	uint32_t random();
+	bool chance(uint16_t permille);
+	UDP *udp;
+	uint8_t *sacnPacket;
+	Stream *streams;
+	uint16_t universe;
+	uint16_t universes;
+	uint8_t sources;
+	uint32_t streamCount;
+	uint32_t streamNext;
+	IPAddress ip;
+	bool unicastMode;
+	bool running;
+	uint16_t framerate;
+	uint32_t startTimestamp;
+	uint64_t scheduled;
+	uint8_t basePriority;
+	uint8_t priorityStep;
+	uint16_t changeRate;
+	uint16_t terminateRate;
+	uint16_t malformedRate;
+	uint32_t malformedBranches;
+	uint8_t malformedNext;
+	uint32_t seed;
+	uint32_t sentCount;
+	uint32_t changedCount;
+	uint32_t terminatedCount;
+	uint32_t malformedCount[MALFORMED_BRANCHES];
+	};
+
+#endif
@@ -0,0 +1,208 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNPixelMap.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// channels and the DMX channel of every strip channel
+static const uint8_t PIXEL_ORDERS[8][5] = {
+	{3, 0, 1, 2, 0}, // RGB
+	{3, 0, 2, 1, 0}, // RBG
+	{3, 1, 0, 2, 0}, // GRB
+	{3, 1, 2, 0, 0}, // GBR
+	{3, 2, 0, 1, 0}, // BRG
+	{3, 2, 1, 0, 0}, // BGR
+	{4, 0, 1, 2, 3}, // RGBW
+	{4, 1, 0, 2, 3}  // GRBW
+	};
+
+PixelMap::PixelMap(uint8_t *buffer, uint16_t pixels, uint16_t universe, uint16_t slot, uint8_t order, uint16_t width) {
+	if(order > PIXEL_GRBW) order = PIXEL_RGB;
+	if(slot == 0 || slot > DMX_SLOTS_MAX) slot = 1;
+	this->buffer = buffer;
+	this->pixels = pixels;
+	this->universe = universe;
+	this->slot = slot;
+	this->width = width;
+	channels = PIXEL_ORDERS[order][0];
+	memcpy(index, PIXEL_ORDERS[order] + 1, 4);
+	// a pixel is never split over two universes
+	uint16_t first = (DMX_SLOTS_MAX - slot + 1) / channels;
+	uint16_t perUniverse = DMX_SLOTS_MAX / channels;
+	universeCount = 1;
+	if(pixels > first) universeCount += (pixels - first + perUniverse - 1) / perUniverse;
+	receivers = new Receiver* [universeCount];
+	changes = new uint32_t [universeCount];
+	for(uint16_t i = 0; i < universeCount; i++) {
+		receivers[i] = NULL;
+		changes[i] = 0;
+		}
+	}
+
+PixelMap::~PixelMap() {
+	delete[] receivers;
+	delete[] changes;
+	}
+
+bool PixelMap::add(Receiver &receiver, uint16_t universe) {
+	uint16_t offset = universe - this->universe;
+	if(offset >= universeCount) return false;
+	receivers[offset] = &receiver;
+	// the current data is mapped with the next update()
+	changes[offset] = receiver.changes() - 1;
+	return true;
+	}
+
+bool PixelMap::update() {
+	bool changed = false;
+	for(uint16_t i = 0; i < universeCount; i++) {
+		if(receivers[i] == NULL) continue;
+		uint32_t count = receivers[i]->changes();
+		if(count == changes[i]) continue;
+		changes[i] = count;
+		map(universe + i, receivers[i]->dmx());
+		changed = true;
+		}
+	return changed;
+	}
+
+void PixelMap::map(uint16_t universe, const uint8_t *dmx) {
+	uint16_t offset = universe - this->universe;
+	if(offset >= universeCount) return;
+	uint16_t first = (DMX_SLOTS_MAX - slot + 1) / channels;
+	uint16_t perUniverse = DMX_SLOTS_MAX / channels;
+	uint16_t pixel = 0;
+	uint16_t count = first;
+	if(offset > 0) {
+		pixel = first + (offset - 1) * perUniverse;
+		count = perUniverse;
+		}
+	else dmx += slot - 1;
+	if(pixel + count > pixels) count = pixels - pixel;
+	if(width == 0) {
+		copy(buffer + pixel * channels, dmx, count, index, channels, false);
+		return;
+		}
+	// serpentine, split into runs inside of a row
+	while(count > 0) {
+		uint16_t row = pixel / width;
+		uint16_t column = pixel % width;
+		uint16_t run = width - column;
+		if(run > count) run = count;
+		if(row & 1) {
+			// the run ends at the start of a reversed row, a partial last row is reversed in itself
+			uint16_t length = (pixels - row * width < width) ? pixels - row * width : width;
+			uint16_t last = row * width + length - column - run;
+			copy(buffer + last * channels, dmx, run, index, channels, true);
+			}
+		else copy(buffer + pixel * channels, dmx, run, index, channels, false);
+		dmx += run * channels;
+		pixel += run;
+		count -= run;
+		}
+	}
+
+uint16_t PixelMap::universes() {
+	return universeCount;
+	}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+static inline uint8x16_t reverse16(uint8x16_t data) {
+	uint8x16_t reversed = vrev64q_u8(data);
+	return vcombine_u8(vget_high_u8(reversed), vget_low_u8(reversed));
+	}
+#endif
+
+void PixelMap::copy(uint8_t *strip, const uint8_t *dmx, uint16_t pixels, const uint8_t *index, uint8_t channels, bool reverse) {
+	uint16_t i = 0;
+	if(!reverse && index[0] == 0 && index[1] == 1 && index[2] == 2 && (channels == 3 || index[3] == 3)) {
+		// same order, a word wide copy
+		memcpy(strip, dmx, pixels * channels);
+		return;
+		}
+#if defined(__SSSE3__)
+	// 5 RGB or 4 RGBW pixels per shuffle, with RGB one spare byte is read and written
+	uint8_t step = 16 / channels;
+	uint8_t spare = 16 - step * channels;
+	uint8_t shuffle[16];
+	for(uint8_t k = 0; k < 16; k++) {
+		uint8_t pixel = k / channels;
+		if(k >= step * channels) shuffle[k] = 0x80;
+		else if(reverse) shuffle[k] = (step - 1 - pixel) * channels + index[k % channels] + spare;
+		else shuffle[k] = pixel * channels + index[k % channels];
+		}
+	__m128i mask = _mm_loadu_si128((const __m128i*)shuffle);
+	for(; i + step + spare <= pixels; i += step) {
+		// reversed, the spare byte is in front of the pixels
+		const uint8_t *source = reverse ? dmx + (pixels - i - step) * channels - spare : dmx + i * channels;
+		__m128i data = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)source), mask);
+		_mm_storeu_si128((__m128i*)(strip + i * channels), data);
+		}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	// 16 pixels deinterleaved into color planes
+	if(channels == 3) {
+		for(; i + 16 <= pixels; i += 16) {
+			uint8x16x3_t in = vld3q_u8(reverse ? dmx + (pixels - i - 16) * 3 : dmx + i * 3);
+			uint8x16x3_t out;
+			for(uint8_t c = 0; c < 3; c++) out.val[c] = reverse ? reverse16(in.val[index[c]]) : in.val[index[c]];
+			vst3q_u8(strip + i * 3, out);
+			}
+		}
+	else {
+		for(; i + 16 <= pixels; i += 16) {
+			uint8x16x4_t in = vld4q_u8(reverse ? dmx + (pixels - i - 16) * 4 : dmx + i * 4);
+			uint8x16x4_t out;
+			for(uint8_t c = 0; c < 4; c++) out.val[c] = reverse ? reverse16(in.val[index[c]]) : in.val[index[c]];
+			vst4q_u8(strip + i * 4, out);
+			}
+		}
+#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) && !defined(__AVR__)
+	// 32 bit cores, one RGBW pixel per word or 4 RGB pixels per 3 words are loaded, permuted and stored
+	uint8_t step = (channels == 4) ? 1 : 4;
+	uint8_t shift[12]; // bit position of the source byte for every byte of the block
+	for(uint8_t k = 0; k < step * channels; k++) {
+		uint8_t pixel = k / channels;
+		shift[k] = ((reverse ? step - 1 - pixel : pixel) * channels + index[k % channels]) * 8;
+		}
+	if(channels == 4) {
+		for(; i < pixels; i++) {
+			uint32_t in, out = 0;
+			memcpy(&in, dmx + (reverse ? pixels - 1 - i : i) * 4, 4);
+			for(uint8_t k = 0; k < 4; k++) out |= ((in >> shift[k]) & 0xFF) << (k * 8);
+			memcpy(strip + i * 4, &out, 4);
+			}
+		}
+	else {
+		for(; i + 4 <= pixels; i += 4) {
+			uint32_t in[3], out[3] = {0, 0, 0};
+			memcpy(in, dmx + (reverse ? pixels - i - 4 : i) * 3, 12);
+			for(uint8_t k = 0; k < 12; k++) out[k >> 2] |= ((in[shift[k] >> 5] >> (shift[k] & 31)) & 0xFF) << ((k & 3) * 8);
+			memcpy(strip + i * 3, out, 12);
+			}
+		}
+#endif
+	for(; i < pixels; i++) {
+		const uint8_t *source = dmx + (reverse ? pixels - 1 - i : i) * channels;
+		uint8_t *target = strip + i * channels;
+		target[0] = source[index[0]];
+		target[1] = source[index[1]];
+		target[2] = source[index[2]];
+		if(channels == 4) target[3] = source[index[3]];
+		}
+	}
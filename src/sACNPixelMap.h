@@ -0,0 +1,108 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_PIXEL_MAP_H
+#define SACN_PIXEL_MAP_H
+
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+// color orders of the strip, the DMX data is always RGB or RGBW
+#define PIXEL_RGB  0
+#define PIXEL_RBG  1
+#define PIXEL_GRB  2
+#define PIXEL_GBR  3
+#define PIXEL_BRG  4
+#define PIXEL_BGR  5
+#define PIXEL_RGBW 6
+#define PIXEL_GRBW 7
+
+/**
+ * @brief Pixel mapping from universes to a LED strip buffer
+ * 
+ * A strip starts at a slot of a universe and continues at slot 1 of the
+ * following universes, a pixel is never split over two universes (170 RGB or
+ * 128 RGBW pixels per universe). The pixels are reordered into the color
+ * order of the strip, with a serpentine layout every second row is reversed.
+ * Only universes with changed data are mapped again.
+ */
+class PixelMap {
+	public:
+	/**
+	 * @brief Construct a new Pixel Map object
+	 * 
+	 * @param buffer strip buffer with pixels * channels bytes
+	 * @param pixels number of pixels
+	 * @param universe start universe
+	 * @param slot start slot 1...512
+	 * @param order color order of the strip
+	 * @param width pixels per row for a serpentine layout, 0 for a straight strip
+	 */
+	PixelMap(uint8_t *buffer, uint16_t pixels, uint16_t universe, uint16_t slot = 1, uint8_t order = PIXEL_RGB, uint16_t width = 0);
+
+	/**
+	 * @brief Destroy the Pixel Map object
+	 * 
+	 */
+	~PixelMap();
+
+	/**
+	 * @brief Add the receiver of a universe of the strip
+	 * 
+	 * @param receiver receiver
+	 * @param universe DMX universe of the receiver
+	 * @return true if the universe is part of the strip
+	 * @return false if the universe is not part of the strip
+	 */
+	bool add(Receiver &receiver, uint16_t universe);
+
+	/**
+	 * @brief Map the changed universes of the receivers, must inside of loop()
+	 * 
+	 * @return true if the strip buffer has changed
+	 * @return false if there is no new data
+	 */
+	bool update();
+
+	/**
+	 * @brief Map DMX data of a universe into the strip buffer
+	 * 
+	 * @param universe DMX universe
+	 * @param dmx DMX universe content
+	 */
+	void map(uint16_t universe, const uint8_t *dmx);
+
+	/**
+	 * @brief Get the number of universes of the strip
+	 * 
+	 * @return uint16_t universes
+	 */
+	uint16_t universes();
+
+	private:
+	static void copy(uint8_t *strip, const uint8_t *dmx, uint16_t pixels, const uint8_t *index, uint8_t channels, bool reverse);
+	uint8_t *buffer;
+	uint16_t pixels;
+	uint16_t universe;
+	uint16_t slot;
+	uint16_t width;
+	uint8_t channels;
+	uint8_t index[4];
+	uint16_t universeCount;
+	Receiver **receivers;
+	uint32_t *changes;
+	};
+
+#endif
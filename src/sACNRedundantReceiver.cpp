@@ -0,0 +1,144 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNRedundantReceiver.h"
+
+RedundantReceiver::RedundantReceiver(Receiver &receiver, UDP *paths[], uint8_t count) {
+	this->receiver = &receiver;
+	if(count > SACN_REDUNDANT_PATHS) count = SACN_REDUNDANT_PATHS;
+	pathCount = count;
+	for(uint8_t i = 0; i < pathCount; i++) {
+		pathList[i] = {};
+		pathList[i].udp = paths[i];
+		}
+	historyCount = 0;
+	historyNext = 0;
+	universe = 0;
+	sacnPacket = new uint8_t [SACN_BUFFER_MAX];
+	}
+
+RedundantReceiver::~RedundantReceiver() {
+	delete[] sacnPacket;
+	}
+
+void RedundantReceiver::begin(uint16_t universe, bool unicastMode) {
+	this->universe = universe;
+	uint8_t mcastIP[4] = {239, 255, (uint8_t)(universe >> 8), (uint8_t)universe};
+	for(uint8_t i = 0; i < pathCount; i++) {
+		if(unicastMode) pathList[i].udp->begin(ACN_SDT_MULTICAST_PORT);
+		else pathList[i].udp->beginMulticast(mcastIP, ACN_SDT_MULTICAST_PORT);
+		pathList[i].timestamp = deviceMillis() - E131_NETWORK_DATA_LOSS_TIMEOUT - 1;
+		}
+	historyCount = 0;
+	historyNext = 0;
+	receiver->begin(universe);
+	}
+
+void RedundantReceiver::stop() {
+	for(uint8_t i = 0; i < pathCount; i++) {
+		pathList[i].udp->stop();
+		}
+	}
+
+uint16_t RedundantReceiver::update() {
+	uint16_t valid = 0;
+	uint32_t now = deviceMillis();
+	bool pending = true;
+	// one packet per network and round, so no network is preferred
+	while(pending) {
+		pending = false;
+		for(uint8_t i = 0; i < pathCount; i++) {
+			int packetSize = pathList[i].udp->parsePacket();
+			if(packetSize <= 0) continue;
+			pending = true;
+			if(packetSize > SACN_BUFFER_MAX) continue;
+			pathList[i].udp->read(sacnPacket, SACN_BUFFER_MAX);
+			if(packetSize < SACN_BUFFER_MIN) continue;
+			if(universe != ((sacnPacket[UNIVERSE_ADDR] << 8) + sacnPacket[UNIVERSE_ADDR + 1])) continue;
+			pathList[i].received++;
+			pathList[i].timestamp = now;
+			// the latency needs the arrival order, so the time is read per datagram
+			if(duplicate(i, deviceMicros())) continue;
+			if(receiver->process(sacnPacket, packetSize, now)) valid++;
+			}
+		}
+	// the receiver has no socket, so update() only checks the data loss timeout
+	receiver->update(now);
+	return valid;
+	}
+
+uint8_t RedundantReceiver::paths() {
+	return pathCount;
+	}
+
+bool RedundantReceiver::active(uint8_t path) {
+	if(path >= pathCount) return false;
+	return (uint32_t)(deviceMillis() - pathList[path].timestamp) <= E131_NETWORK_DATA_LOSS_TIMEOUT;
+	}
+
+uint32_t RedundantReceiver::received(uint8_t path) {
+	if(path >= pathCount) return 0;
+	return pathList[path].received;
+	}
+
+uint32_t RedundantReceiver::first(uint8_t path) {
+	if(path >= pathCount) return 0;
+	return pathList[path].first;
+	}
+
+uint32_t RedundantReceiver::lost(uint8_t path) {
+	if(path >= pathCount) return 0;
+	return pathList[path].lost;
+	}
+
+uint32_t RedundantReceiver::latency(uint8_t path) {
+	if(path >= pathCount) return 0;
+	return pathList[path].latency;
+	}
+
+bool RedundantReceiver::duplicate(uint8_t path, uint32_t now) {
+	uint8_t seqNumber = sacnPacket[SEQ_NUM_ADDR];
+	const uint8_t *cid = sacnPacket + CID_ADDR;
+	uint32_t sample = 0;
+	bool found = false;
+	for(uint8_t i = 0; i < historyCount; i++) {
+		History &entry = history[i];
+		if(entry.seqNumber != seqNumber || memcmp(entry.cid, cid, CID_SIZE) != 0) continue;
+		if(entry.paths & (1 << path)) return true; // a copy on the same network
+		entry.paths |= 1 << path;
+		sample = now - entry.timestamp;
+		found = true;
+		break;
+		}
+	if(!found) {
+		// the oldest packet is forgotten, every network without it has lost it
+		History &entry = history[historyNext];
+		if(historyCount == SACN_REDUNDANT_HISTORY) {
+			for(uint8_t i = 0; i < pathCount; i++) {
+				if(!(entry.paths & (1 << i))) pathList[i].lost++;
+				}
+			}
+		else historyCount++;
+		memcpy(entry.cid, cid, CID_SIZE);
+		entry.seqNumber = seqNumber;
+		entry.paths = 1 << path;
+		entry.timestamp = now;
+		historyNext = (historyNext + 1) % SACN_REDUNDANT_HISTORY;
+		pathList[path].first++;
+		}
+	// average of the last 8 packets
+	Path &current = pathList[path];
+	current.latency += ((int32_t)sample - (int32_t)current.latency) / 8;
+	return found;
+	}
@@ -0,0 +1,144 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_REDUNDANT_RECEIVER_H
+#define SACN_REDUNDANT_RECEIVER_H
+
+#include "Arduino.h"
+#include "Udp.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+/**
+ * @brief Redundant receive of a universe over several networks
+ * 
+ * Sources send the same universe on a primary and a secondary network, every
+ * network has its own socket. The first copy of a packet is handed over to
+ * the receiver, later copies with the same CID and sequence number are
+ * dropped. So a failed network costs no frame. For every network the lost
+ * packets and the latency behind the fastest network are tracked.
+ */
+class RedundantReceiver {
+	public:
+	/**
+	 * @brief Construct a new Redundant Receiver object
+	 * 
+	 * @param receiver receiver for the universe, must created without a socket
+	 * @param paths sockets of the networks
+	 * @param count number of networks, max 8
+	 */
+	RedundantReceiver(Receiver &receiver, UDP *paths[], uint8_t count);
+
+	/**
+	 * @brief Destroy the Redundant Receiver object
+	 * 
+	 */
+	~RedundantReceiver();
+
+	/**
+	 * @brief Begin the socket connections and the receiver
+	 * 
+	 * @param universe DMX universe to receive
+	 * @param unicastMode allows to receive from unicast source
+	 */
+	void begin(uint16_t universe, bool unicastMode = false);
+
+	/**
+	 * @brief Stop all socket connections
+	 * 
+	 */
+	void stop();
+
+	/**
+	 * @brief Receive from all networks and proceed the first copies, must inside of loop()
+	 * 
+	 * @return uint16_t number of valid packets
+	 */
+	uint16_t update();
+
+	/**
+	 * @brief Get the number of networks
+	 * 
+	 * @return uint8_t networks
+	 */
+	uint8_t paths();
+
+	/**
+	 * @brief Get the state of a network
+	 * 
+	 * @param path network index
+	 * @return true if a packet was received inside of the network data loss timeout
+	 * @return false if the network has failed
+	 */
+	bool active(uint8_t path);
+
+	/**
+	 * @brief Get the number of received packets of a network, including the copies
+	 * 
+	 * @param path network index
+	 * @return uint32_t packets
+	 */
+	uint32_t received(uint8_t path);
+
+	/**
+	 * @brief Get the number of packets which arrived first over a network
+	 * 
+	 * @param path network index
+	 * @return uint32_t packets
+	 */
+	uint32_t first(uint8_t path);
+
+	/**
+	 * @brief Get the number of packets which arrived over another network only
+	 * 
+	 * @param path network index
+	 * @return uint32_t packets
+	 */
+	uint32_t lost(uint8_t path);
+
+	/**
+	 * @brief Get the average latency behind the fastest network
+	 * 
+	 * @param path network index
+	 * @return uint32_t latency in us
+	 */
+	uint32_t latency(uint8_t path);
+
+	private:
+	struct History {
+		uint8_t cid[16];
+		uint8_t seqNumber;
+		uint8_t paths; // bit mask of the networks which delivered the packet
+		uint32_t timestamp; // first arrival in us
+		};
+	struct Path {
+		UDP *udp;
+		uint32_t timestamp;
+		uint32_t received;
+		uint32_t first;
+		uint32_t lost;
+		uint32_t latency;
+		};
+	bool duplicate(uint8_t path, uint32_t now);
+	Receiver *receiver;
+	Path pathList[SACN_REDUNDANT_PATHS];
+	uint8_t pathCount;
+	History history[SACN_REDUNDANT_HISTORY];
+	uint8_t historyCount;
+	uint8_t historyNext;
+	uint16_t universe;
+	uint8_t *sacnPacket;
+	};
+
+#endif
@@ -0,0 +1,260 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNShardedReceiver.h"
+
+#if defined(__linux__)
+
+#include <sys/socket.h>
+#include <linux/filter.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+ShardedReceiver::ShardedReceiver(uint16_t universe, uint16_t universes, uint8_t workers) {
+	if(universes == 0) universes = 1;
+	if(workers == 0) {
+		// the CPUs the process may run on, not all CPUs of the system
+		cpu_set_t allowed;
+		int cores = sched_getaffinity(0, sizeof(allowed), &allowed) == 0 ? CPU_COUNT(&allowed) : 1;
+		workers = (cores > 0 && cores < 255) ? cores : 1;
+		}
+	// every worker has at least one universe
+	if(workers > universes) workers = universes;
+	this->universe = universe;
+	universeCount = universes;
+	workerCount = workers;
+	running = false;
+	sharedTable = NULL;
+	receivers = new Receiver [universeCount];
+	for(uint16_t i = 0; i < universeCount; i++) receivers[i].begin(universe + i);
+	void *memory = NULL;
+	if(posix_memalign(&memory, 64, universeCount * sizeof(Frame)) != 0) memory = NULL;
+	frames = (Frame*)memory;
+	if(frames != NULL) memset(frames, 0, universeCount * sizeof(Frame));
+	memory = NULL;
+	if(posix_memalign(&memory, 64, workerCount * sizeof(Worker)) != 0) memory = NULL;
+	workerList = (Worker*)memory;
+	if(workerList != NULL) {
+		memset(workerList, 0, workerCount * sizeof(Worker));
+		for(uint8_t i = 0; i < workerCount; i++) {
+			workerList[i].owner = this;
+			workerList[i].index = i;
+			}
+		}
+	}
+
+ShardedReceiver::~ShardedReceiver() {
+	stop();
+	delete[] receivers;
+	free(frames);
+	free(workerList);
+	}
+
+bool ShardedReceiver::begin() {
+	stop();
+	if(frames == NULL || workerList == NULL) return false;
+	// the sockets are bound in worker order, this is the index for the BPF program
+	for(uint8_t i = 0; i < workerCount; i++) {
+		Worker &worker = workerList[i];
+		worker.socket = new SocketUDP(true);
+		bool first = true;
+		for(uint32_t u = universe; u < (uint32_t)universe + universeCount; u++) {
+			if(u % workerCount != i) continue;
+			IPAddress group(239, 255, u >> 8, u & 0xFF);
+			bool joined = first ? worker.socket->beginMulticast(group, ACN_SDT_MULTICAST_PORT) : worker.socket->join(group);
+			if(!joined) {
+				stop();
+				return false;
+				}
+			first = false;
+			}
+		}
+	steer();
+	__atomic_store_n(&running, true, __ATOMIC_RELEASE);
+	cpu_set_t allowed;
+	int cores = sched_getaffinity(0, sizeof(allowed), &allowed) == 0 ? CPU_COUNT(&allowed) : 0;
+	for(uint8_t i = 0; i < workerCount; i++) {
+		Worker &worker = workerList[i];
+		if(pthread_create(&worker.thread, NULL, run, &worker) != 0) {
+			stop();
+			return false;
+			}
+		worker.started = true;
+		if(cores > 1) {
+			// the workers are spread over the CPUs of the process mask
+			int cpu = 0;
+			for(int n = i % cores; cpu < CPU_SETSIZE; cpu++) {
+				if(CPU_ISSET(cpu, &allowed) && n-- == 0) break;
+				}
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			CPU_SET(cpu, &cpus);
+			// an unpinned worker still runs on the CPUs of the process
+			worker.pinned = pthread_setaffinity_np(worker.thread, sizeof(cpus), &cpus) == 0;
+			}
+		}
+	return true;
+	}
+
+void ShardedReceiver::stop() {
+	__atomic_store_n(&running, false, __ATOMIC_RELEASE);
+	if(workerList == NULL) return;
+	for(uint8_t i = 0; i < workerCount; i++) {
+		Worker &worker = workerList[i];
+		if(worker.started) pthread_join(worker.thread, NULL);
+		worker.started = false;
+		worker.pinned = false;
+		delete worker.socket;
+		worker.socket = NULL;
+		}
+	}
+
+bool ShardedReceiver::dmx(uint16_t universe, uint8_t *data) {
+	uint16_t offset = universe - this->universe;
+	if(offset >= universeCount || frames == NULL) return false;
+	Frame &frame = frames[offset];
+	uint32_t before, after;
+	bool active;
+	do {
+		before = __atomic_load_n(&frame.sequence, __ATOMIC_ACQUIRE);
+		memcpy(data, frame.dmx, DMX_SLOTS_MAX);
+		active = __atomic_load_n(&frame.active, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		after = __atomic_load_n(&frame.sequence, __ATOMIC_RELAXED);
+		} while((before & 1) || before != after);
+	return active;
+	}
+
+uint32_t ShardedReceiver::changes(uint16_t universe) {
+	uint16_t offset = universe - this->universe;
+	if(offset >= universeCount || frames == NULL) return 0;
+	return __atomic_load_n(&frames[offset].changes, __ATOMIC_RELAXED);
+	}
+
+bool ShardedReceiver::sources(uint16_t universe) {
+	uint16_t offset = universe - this->universe;
+	if(offset >= universeCount || frames == NULL) return false;
+	return __atomic_load_n(&frames[offset].active, __ATOMIC_ACQUIRE);
+	}
+
+void ShardedReceiver::share(SharedTable &table) {
+	sharedTable = &table;
+	}
+
+uint8_t ShardedReceiver::workers() {
+	return workerCount;
+	}
+
+uint32_t ShardedReceiver::packets(uint8_t worker) {
+	if(worker >= workerCount || workerList == NULL) return 0;
+	return __atomic_load_n(&workerList[worker].packets, __ATOMIC_RELAXED);
+	}
+
+uint32_t ShardedReceiver::dropped(uint8_t worker) {
+	if(worker >= workerCount || workerList == NULL) return 0;
+	return __atomic_load_n(&workerList[worker].dropped, __ATOMIC_RELAXED);
+	}
+
+bool ShardedReceiver::pinned(uint8_t worker) {
+	if(worker >= workerCount || workerList == NULL) return false;
+	return workerList[worker].pinned;
+	}
+
+void *ShardedReceiver::run(void *context) {
+	Worker *worker = (Worker*)context;
+	uint8_t *packet = new uint8_t [SACN_BUFFER_MAX];
+	worker->owner->receive(*worker, packet);
+	delete[] packet;
+	return NULL;
+	}
+
+void ShardedReceiver::receive(Worker &worker, uint8_t *packet) {
+	struct pollfd event = {};
+	event.fd = worker.socket->fd();
+	event.events = POLLIN;
+	// offset of the first universe of this worker
+	uint16_t first = (worker.index + workerCount - universe % workerCount) % workerCount;
+	uint32_t checked = deviceMillis();
+	while(__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+		poll(&event, 1, SACN_SHARD_POLL);
+		// the time is sampled once per wake up, not per packet
+		uint32_t now = deviceMillis();
+		int size;
+		while((size = worker.socket->parsePacket()) > 0) {
+			worker.socket->read(packet, SACN_BUFFER_MAX);
+			__atomic_add_fetch(&worker.packets, 1, __ATOMIC_RELAXED);
+			uint16_t offset = universeCount;
+			if(size >= SACN_BUFFER_MIN) {
+				uint16_t packetUniverse = (packet[UNIVERSE_ADDR] << 8) + packet[UNIVERSE_ADDR + 1];
+				if(packetUniverse % workerCount == worker.index) offset = packetUniverse - universe;
+				}
+			if(offset >= universeCount) {
+				__atomic_add_fetch(&worker.dropped, 1, __ATOMIC_RELAXED);
+				continue;
+				}
+			Receiver &receiver = receivers[offset];
+			uint32_t count = receiver.changes();
+			if(!receiver.process(packet, size, now)) continue;
+			bool changed = receiver.changes() != count;
+			if(changed || !frames[offset].active) publish(offset, changed);
+			// every worker publishes only its own universes into the shared table
+			if(sharedTable != NULL) sharedTable->publish(universe + offset, receiver);
+			}
+		// data loss timeouts of the own universes
+		if((uint32_t)(now - checked) >= SACN_SHARD_POLL) {
+			checked = now;
+			for(uint16_t offset = first; offset < universeCount; offset += workerCount) {
+				receivers[offset].update(now);
+				if(frames[offset].active && !receivers[offset].sources()) {
+					publish(offset, false);
+					if(sharedTable != NULL) sharedTable->publish(universe + offset, receivers[offset]);
+					}
+				}
+			}
+		}
+	}
+
+void ShardedReceiver::publish(uint16_t offset, bool changed) {
+	// only the owning worker writes a frame
+	Frame &frame = frames[offset];
+	uint32_t sequence = frame.sequence;
+	__atomic_store_n(&frame.sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(frame.dmx, receivers[offset].dmx(), DMX_SLOTS_MAX);
+	__atomic_store_n(&frame.active, receivers[offset].sources(), __ATOMIC_RELAXED);
+	__atomic_store_n(&frame.sequence, sequence + 2, __ATOMIC_RELEASE);
+	// a new source or a timeout is published without a change of the DMX data
+	if(changed) __atomic_store_n(&frame.changes, frame.changes + 1, __ATOMIC_RELAXED);
+	}
+
+bool ShardedReceiver::steer() {
+	// unicast packets go to the socket with the index universe % workers
+	struct sock_filter code[] = {
+		{BPF_LD | BPF_H | BPF_ABS, 0, 0, UNIVERSE_ADDR},
+		{BPF_ALU | BPF_MOD | BPF_K, 0, 0, workerCount},
+		{BPF_RET | BPF_A, 0, 0, 0}
+		};
+	struct sock_fprog program = {};
+	program.len = sizeof(code) / sizeof(code[0]);
+	program.filter = code;
+	return setsockopt(workerList[0].socket->fd(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0;
+	}
+
+#endif
@@ -0,0 +1,170 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_SHARDED_RECEIVER_H
+#define SACN_SHARDED_RECEIVER_H
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+#include "sACNSocketUDP.h"
+#include "sACNSharedTable.h"
+
+/**
+ * @brief Multi core receive for many universes on Linux hosts
+ * 
+ * Every worker thread owns a socket bound with SO_REUSEPORT to the sACN port
+ * and the receivers of the universes with universe % workers == worker.
+ * Multicast is steered by the groups, every socket joins only the groups of
+ * its worker. Unicast is steered by a BPF program on the universe field, on
+ * older kernels packets for a universe of another worker are dropped. The
+ * DMX data is published per universe with a sequence lock, so readers never
+ * block the workers.
+ */
+class ShardedReceiver {
+	public:
+	/**
+	 * @brief Construct a new Sharded Receiver object
+	 * 
+	 * @param universe first DMX universe
+	 * @param universes number of universes
+	 * @param workers number of worker threads, 0 for one per core
+	 */
+	ShardedReceiver(uint16_t universe, uint16_t universes, uint8_t workers = 0);
+
+	/**
+	 * @brief Destroy the Sharded Receiver object
+	 * 
+	 */
+	~ShardedReceiver();
+
+	/**
+	 * @brief Open the sockets and start the worker threads
+	 * 
+	 * @return true if all workers are running
+	 * @return false on error
+	 */
+	bool begin();
+
+	/**
+	 * @brief Stop the worker threads and close the sockets
+	 * 
+	 */
+	void stop();
+
+	/**
+	 * @brief Get a consistent copy of the DMX data of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @param data buffer for 512 slots
+	 * @return true if the universe has an active source
+	 * @return false if there is no source or the universe is unknown
+	 */
+	bool dmx(uint16_t universe, uint8_t *data);
+
+	/**
+	 * @brief Get the number of DMX data changes of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @return uint32_t change counter
+	 */
+	uint32_t changes(uint16_t universe);
+
+	/**
+	 * @brief Get the state of the source of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @return true if the source is active
+	 * @return false if there is no source
+	 */
+	bool sources(uint16_t universe);
+
+	/**
+	 * @brief Publish the universes also into a shared table for other processes,
+	 * the table must be created before begin()
+	 * 
+	 * @param table shared table
+	 */
+	void share(SharedTable &table);
+
+	/**
+	 * @brief Get the number of workers
+	 * 
+	 * @return uint8_t workers
+	 */
+	uint8_t workers();
+
+	/**
+	 * @brief Get the number of received packets of a worker
+	 * 
+	 * @param worker worker index
+	 * @return uint32_t packets
+	 */
+	uint32_t packets(uint8_t worker);
+
+	/**
+	 * @brief Get the number of dropped packets of a worker, for universes of other workers or not in the range
+	 * 
+	 * @param worker worker index
+	 * @return uint32_t packets
+	 */
+	uint32_t dropped(uint8_t worker);
+
+	/**
+	 * @brief Get the state of the CPU affinity of a worker, the workers are spread over the CPUs
+	 * of the process mask
+	 * 
+	 * @param worker worker index
+	 * @return true if the worker is pinned to one CPU
+	 * @return false if the worker runs on any CPU of the process
+	 */
+	bool pinned(uint8_t worker);
+
+	private:
+	struct __attribute__((aligned(64))) Frame {
+		uint32_t sequence; // odd while the worker writes
+		bool active;
+		uint32_t changes; // DMX data changes, written only by the owning worker
+		uint8_t dmx[DMX_SLOTS_MAX];
+		};
+	struct __attribute__((aligned(64))) Worker {
+		ShardedReceiver *owner;
+		uint8_t index;
+		pthread_t thread;
+		bool started;
+		bool pinned;
+		SocketUDP *socket;
+		uint32_t packets;
+		uint32_t dropped;
+		};
+	static void *run(void *context);
+	void receive(Worker &worker, uint8_t *packet);
+	void publish(uint16_t offset, bool changed);
+	bool steer();
+	uint16_t universe;
+	uint16_t universeCount;
+	uint8_t workerCount;
+	bool running;
+	SharedTable *sharedTable;
+	Receiver *receivers;
+	Frame *frames;
+	Worker *workerList;
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,243 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNSharedTable.h"
+
+#if defined(__linux__)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHARED_MAGIC   0x4E434173 // "sACN"
+#define SHARED_VERSION 1
+
+SharedTable::SharedTable(const char *name) {
+	strncpy(this->name, name, sizeof(this->name) - 1);
+	this->name[sizeof(this->name) - 1] = 0;
+	header = NULL;
+	slots = NULL;
+	mapSize = 0;
+	creator = false;
+	entries = NULL;
+	entryCount = 0;
+	}
+
+SharedTable::~SharedTable() {
+	close();
+	}
+
+bool SharedTable::create(uint16_t universe, uint16_t universes) {
+	close();
+	if(universes == 0) return false;
+	// readers of a former table keep their mapping, new readers get the new table
+	shm_unlink(name);
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if(fd < 0) return false;
+	size_t size = sizeof(Header) + (size_t)universes * sizeof(Slot);
+	if(ftruncate(fd, size) != 0) {
+		::close(fd);
+		shm_unlink(name);
+		return false;
+		}
+	void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(map == MAP_FAILED) {
+		shm_unlink(name);
+		return false;
+		}
+	// the memory of a new object is zero, so all slots are inactive
+	header = (Header*)map;
+	slots = (Slot*)(header + 1);
+	mapSize = size;
+	creator = true;
+	header->version = SHARED_VERSION;
+	header->universe = universe;
+	header->universes = universes;
+	header->slotSize = sizeof(Slot);
+	__atomic_store_n(&header->magic, SHARED_MAGIC, __ATOMIC_RELEASE);
+	entries = new Entry [universes];
+	entryCount = 0;
+	return true;
+	}
+
+bool SharedTable::open() {
+	close();
+	int fd = shm_open(name, O_RDONLY, 0);
+	if(fd < 0) return false;
+	struct stat status;
+	if(fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(Header)) {
+		::close(fd);
+		return false;
+		}
+	void *map = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(map == MAP_FAILED) return false;
+	Header *table = (Header*)map;
+	size_t size = sizeof(Header) + (size_t)table->universes * sizeof(Slot);
+	if(__atomic_load_n(&table->magic, __ATOMIC_ACQUIRE) != SHARED_MAGIC || table->version != SHARED_VERSION
+		|| table->slotSize != sizeof(Slot) || size > (size_t)status.st_size) {
+		munmap(map, status.st_size);
+		return false;
+		}
+	header = table;
+	slots = (Slot*)(header + 1);
+	mapSize = status.st_size;
+	creator = false;
+	return true;
+	}
+
+void SharedTable::close() {
+	if(header != NULL) {
+		munmap(header, mapSize);
+		if(creator) shm_unlink(name);
+		}
+	header = NULL;
+	slots = NULL;
+	mapSize = 0;
+	creator = false;
+	delete[] entries;
+	entries = NULL;
+	entryCount = 0;
+	}
+
+bool SharedTable::add(Receiver &receiver, uint16_t universe) {
+	if(!creator || find(universe) == NULL || entryCount >= header->universes) return false;
+	entries[entryCount].receiver = &receiver;
+	entries[entryCount].universe = universe;
+	entries[entryCount].packets = receiver.packets() - 1; // published with the first update()
+	entries[entryCount].active = receiver.sources();
+	entryCount++;
+	return true;
+	}
+
+uint16_t SharedTable::update() {
+	uint16_t published = 0;
+	for(uint16_t i = 0; i < entryCount; i++) {
+		Entry &entry = entries[i];
+		uint32_t packets = entry.receiver->packets();
+		bool active = entry.receiver->sources();
+		if(packets == entry.packets && active == entry.active) continue;
+		entry.packets = packets;
+		entry.active = active;
+		if(publish(entry.universe, *entry.receiver)) published++;
+		}
+	return published;
+	}
+
+bool SharedTable::publish(uint16_t universe, Receiver &receiver) {
+	if(!creator) return false;
+	Slot *slot = find(universe);
+	if(slot == NULL) return false;
+	uint32_t sequence = slot->sequence;
+	__atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	Info &info = slot->info;
+	if(info.changes != receiver.changes()) {
+		memcpy(slot->dmx, receiver.dmx(), DMX_SLOTS_MAX);
+		info.changes = receiver.changes();
+		}
+	if(info.packets != receiver.packets()) {
+		info.packets = receiver.packets();
+		info.updated = monotonic();
+		}
+	if(memcmp(info.cid, receiver.cid(), CID_SIZE) != 0) {
+		memcpy(info.cid, receiver.cid(), CID_SIZE);
+		memcpy(info.name, receiver.name(), SOURCE_NAME_SIZE);
+		}
+	info.active = receiver.sources();
+	info.priority = receiver.priority();
+	info.framerate = receiver.framerate();
+	__atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+	return true;
+	}
+
+bool SharedTable::dmx(uint16_t universe, uint8_t *data) {
+	Slot *slot = find(universe);
+	if(slot == NULL) return false;
+	uint32_t before;
+	bool active;
+	do {
+		before = sequence(universe);
+		memcpy(data, slot->dmx, DMX_SLOTS_MAX);
+		active = __atomic_load_n(&slot->info.active, __ATOMIC_RELAXED);
+		} while(!verify(universe, before));
+	return active;
+	}
+
+const uint8_t* SharedTable::dmx(uint16_t universe) {
+	Slot *slot = find(universe);
+	if(slot == NULL) return NULL;
+	return slot->dmx;
+	}
+
+uint32_t SharedTable::sequence(uint16_t universe) {
+	Slot *slot = find(universe);
+	if(slot == NULL) return 0;
+	uint32_t sequence;
+	while((sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE)) & 1) {
+		sched_yield();
+		}
+	return sequence;
+	}
+
+bool SharedTable::verify(uint16_t universe, uint32_t sequence) {
+	Slot *slot = find(universe);
+	if(slot == NULL) return false;
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence;
+	}
+
+bool SharedTable::info(uint16_t universe, Info &info) {
+	Slot *slot = find(universe);
+	if(slot == NULL) return false;
+	uint32_t before;
+	do {
+		before = sequence(universe);
+		memcpy(&info, &slot->info, sizeof(Info));
+		} while(!verify(universe, before));
+	return true;
+	}
+
+uint32_t SharedTable::age(uint16_t universe) {
+	Info state;
+	if(!info(universe, state) || state.packets == 0) return UINT32_MAX;
+	return monotonic() - state.updated;
+	}
+
+uint16_t SharedTable::universe() {
+	return header != NULL ? header->universe : 0;
+	}
+
+uint16_t SharedTable::universes() {
+	return header != NULL ? header->universes : 0;
+	}
+
+SharedTable::Slot* SharedTable::find(uint16_t universe) {
+	if(header == NULL) return NULL;
+	uint16_t offset = universe - header->universe;
+	if(offset >= header->universes) return NULL;
+	return &slots[offset];
+	}
+
+uint32_t SharedTable::monotonic() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+	}
+
+#endif
@@ -0,0 +1,210 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_SHARED_TABLE_H
+#define SACN_SHARED_TABLE_H
+
+#if defined(__linux__)
+
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+/**
+ * @brief Universe table in POSIX shared memory for other processes on Linux hosts
+ * 
+ * One process receives the universes and publishes them into the table,
+ * any number of other processes map the table read only and get the DMX
+ * data and the source information without an own sACN stack, without a
+ * copy and without a syscall. Every universe has an own sequence lock, so
+ * readers never block the publisher.
+ */
+class SharedTable {
+	public:
+	/**
+	 * @brief Information about the source of a universe
+	 * 
+	 */
+	struct Info {
+		bool active;
+		uint8_t priority;
+		uint8_t framerate;
+		uint32_t changes;
+		uint32_t packets;
+		uint32_t updated; // CLOCK_MONOTONIC in ms
+		uint8_t cid[16];
+		char name[64];
+		};
+
+	/**
+	 * @brief Construct a new Shared Table object
+	 * 
+	 * @param name name of the shared memory object
+	 */
+	SharedTable(const char *name = SACN_SHARED_NAME);
+
+	/**
+	 * @brief Destroy the Shared Table object
+	 * 
+	 */
+	~SharedTable();
+
+	/**
+	 * @brief Create the table for publishing, an existing table is replaced
+	 * 
+	 * @param universe first DMX universe
+	 * @param universes number of universes
+	 * @return true if the table is created
+	 * @return false on error
+	 */
+	bool create(uint16_t universe, uint16_t universes);
+
+	/**
+	 * @brief Open an existing table read only
+	 * 
+	 * @return true if the table is mapped
+	 * @return false if there is no valid table
+	 */
+	bool open();
+
+	/**
+	 * @brief Unmap the table, the creator also removes the name
+	 * 
+	 */
+	void close();
+
+	/**
+	 * @brief Add the receiver of a universe for update()
+	 * 
+	 * @param receiver receiver
+	 * @param universe DMX universe of the receiver
+	 * @return true if the universe is part of the table
+	 * @return false if not or there is no space left
+	 */
+	bool add(Receiver &receiver, uint16_t universe);
+
+	/**
+	 * @brief Publish the added receivers with new packets or a changed source state, must inside of loop()
+	 * 
+	 * @return uint16_t number of published universes
+	 */
+	uint16_t update();
+
+	/**
+	 * @brief Publish the state of a receiver, the DMX data is only copied when it has changed,
+	 * every universe must have a single publisher
+	 * 
+	 * @param universe DMX universe
+	 * @param receiver receiver of the universe
+	 * @return true if published
+	 * @return false if the universe is not part of the table
+	 */
+	bool publish(uint16_t universe, Receiver &receiver);
+
+	/**
+	 * @brief Get a consistent copy of the DMX data of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @param data buffer for 512 slots
+	 * @return true if the universe has an active source
+	 * @return false if there is no source or the universe is unknown
+	 */
+	bool dmx(uint16_t universe, uint8_t *data);
+
+	/**
+	 * @brief Get the DMX data of a universe inside of the table without a copy,
+	 * check the read with sequence() and verify()
+	 * 
+	 * @param universe DMX universe
+	 * @return const uint8_t* DMX data, NULL if the universe is unknown
+	 */
+	const uint8_t* dmx(uint16_t universe);
+
+	/**
+	 * @brief Start a read of a universe, waits while the publisher writes
+	 * 
+	 * @param universe DMX universe
+	 * @return uint32_t sequence for verify()
+	 */
+	uint32_t sequence(uint16_t universe);
+
+	/**
+	 * @brief Finish a read of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @param sequence sequence from the start of the read
+	 * @return true if the data was not changed during the read
+	 * @return false if the read must be repeated
+	 */
+	bool verify(uint16_t universe, uint32_t sequence);
+
+	/**
+	 * @brief Get a consistent copy of the source information of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @param info buffer for the information
+	 * @return true if the universe is part of the table
+	 * @return false if not
+	 */
+	bool info(uint16_t universe, Info &info);
+
+	/**
+	 * @brief Get the time since the last packet of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @return uint32_t time in ms, UINT32_MAX if there was no packet
+	 */
+	uint32_t age(uint16_t universe);
+
+	/**
+	 * @brief Get the universe range of the table
+	 * 
+	 * @return uint16_t first universe or number of universes
+	 */
+	uint16_t universe();
+	uint16_t universes();
+
+	private:
+	struct __attribute__((aligned(64))) Header {
+		uint32_t magic;
+		uint16_t version;
+		uint16_t universe;
+		uint16_t universes;
+		uint16_t slotSize;
+		};
+	struct __attribute__((aligned(64))) Slot {
+		uint32_t sequence; // odd while the publisher writes
+		Info info;
+		uint8_t dmx[DMX_SLOTS_MAX];
+		};
+	struct Entry {
+		Receiver *receiver;
+		uint16_t universe;
+		uint32_t packets;
+		bool active;
+		};
+	Slot *find(uint16_t universe);
+	static uint32_t monotonic();
+	char name[64];
+	Header *header;
+	Slot *slots;
+	size_t mapSize;
+	bool creator;
+	Entry *entries;
+	uint16_t entryCount;
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,198 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNSnapshot.h"
+
+#define SNAPSHOT_MAGIC  0x4E434173 // "sACN"
+#define SNAPSHOT_RECORD (2 + DMX_SLOTS_MAX) // universe and DMX data
+#define SNAPSHOT_CHUNK  64 // bytes read at once for the CRC check
+
+Snapshot::Snapshot(Storage &storage, uint16_t universes, uint8_t slots) {
+	this->storage = &storage;
+	entryMax = universes;
+	entryCount = 0;
+	entries = new Entry [entryMax];
+	uint32_t fit = storage.size() / slotSize();
+	slotCount = fit < slots ? fit : slots;
+	slotNext = 0;
+	generation = 0;
+	savedCRC = 0;
+	snapshotInterval = SACN_SNAPSHOT_INTERVAL;
+	timestamp = deviceMillis();
+	writeCount = 0;
+	scanned = false;
+	}
+
+Snapshot::~Snapshot() {
+	delete[] entries;
+	}
+
+bool Snapshot::add(Receiver &receiver, uint16_t universe) {
+	if(entryCount >= entryMax) return false;
+	entries[entryCount].receiver = &receiver;
+	entries[entryCount].universe = universe;
+	entries[entryCount].changes = receiver.changes();
+	entryCount++;
+	return true;
+	}
+
+uint16_t Snapshot::restore() {
+	uint16_t restored = 0;
+	Header header;
+	int8_t slot = newest(header);
+	if(slot >= 0) {
+		uint8_t *data = new uint8_t [DMX_SLOTS_MAX];
+		uint32_t address = slot * slotSize() + sizeof(Header);
+		for(uint16_t i = 0; i < header.universes; i++, address += SNAPSHOT_RECORD) {
+			uint8_t universe[2];
+			if(!storage->read(address, universe, 2)) break;
+			for(uint16_t j = 0; j < entryCount; j++) {
+				if(entries[j].universe != ((universe[0] << 8) | universe[1])) continue;
+				if(!storage->read(address + 2, data, DMX_SLOTS_MAX)) break;
+				entries[j].receiver->restore(data);
+				restored++;
+				break;
+				}
+			}
+		delete[] data;
+		}
+	// the restored data needs no new snapshot
+	for(uint16_t i = 0; i < entryCount; i++) entries[i].changes = entries[i].receiver->changes();
+	savedCRC = checksum();
+	return restored;
+	}
+
+bool Snapshot::update() {
+	if((uint32_t)(deviceMillis() - timestamp) < snapshotInterval) return false;
+	bool changed = false;
+	for(uint16_t i = 0; i < entryCount; i++) {
+		if(entries[i].receiver->changes() != entries[i].changes) changed = true;
+		}
+	if(!changed) return false;
+	// a failed snapshot is tried again after the next interval
+	timestamp = deviceMillis();
+	return save();
+	}
+
+bool Snapshot::save() {
+	if(slotCount == 0 || entryCount == 0) return false;
+	// data which changed and returned to the saved look is not written again
+	uint16_t crc = checksum();
+	if(crc == savedCRC) {
+		for(uint16_t i = 0; i < entryCount; i++) entries[i].changes = entries[i].receiver->changes();
+		return false;
+		}
+	if(!scanned) {
+		Header newestHeader;
+		newest(newestHeader);
+		}
+	Header header;
+	header.magic = SNAPSHOT_MAGIC;
+	header.generation = generation + 1;
+	header.universes = entryCount;
+	header.crc = crc16(0xFFFF, (const uint8_t*)&header.generation, sizeof(header.generation) + sizeof(header.universes));
+	uint32_t base = slotNext * slotSize();
+	uint32_t address = base + sizeof(Header);
+	for(uint16_t i = 0; i < entryCount; i++, address += SNAPSHOT_RECORD) {
+		uint8_t universe[2] = {(uint8_t)(entries[i].universe >> 8), (uint8_t)entries[i].universe};
+		const uint8_t *dmx = entries[i].receiver->dmx();
+		header.crc = crc16(header.crc, universe, 2);
+		header.crc = crc16(header.crc, dmx, DMX_SLOTS_MAX);
+		if(!storage->write(address, universe, 2)) return false;
+		if(!storage->write(address + 2, dmx, DMX_SLOTS_MAX)) return false;
+		}
+	// the header is written last, an interrupted snapshot has no valid header
+	if(!storage->write(base, (const uint8_t*)&header, sizeof(Header))) return false;
+	if(!storage->commit()) return false;
+	// the changes count as saved only after a successful commit, so a failed snapshot is repeated
+	for(uint16_t i = 0; i < entryCount; i++) entries[i].changes = entries[i].receiver->changes();
+	generation = header.generation;
+	slotNext = (slotNext + 1) % slotCount;
+	savedCRC = crc;
+	timestamp = deviceMillis();
+	writeCount++;
+	return true;
+	}
+
+void Snapshot::interval(uint32_t interval) {
+	snapshotInterval = interval;
+	}
+
+uint8_t Snapshot::slots() {
+	return slotCount;
+	}
+
+uint32_t Snapshot::writes() {
+	return writeCount;
+	}
+
+int8_t Snapshot::newest(Header &header) {
+	int8_t slot = -1;
+	for(uint8_t i = 0; i < slotCount; i++) {
+		Header current;
+		if(!valid(i, current)) continue;
+		if(slot < 0 || (int32_t)(current.generation - header.generation) > 0) {
+			slot = i;
+			header = current;
+			}
+		}
+	// the next snapshot goes to the slot after the newest one
+	scanned = true;
+	if(slot >= 0) {
+		generation = header.generation;
+		slotNext = (slot + 1) % slotCount;
+		}
+	return slot;
+	}
+
+bool Snapshot::valid(uint8_t slot, Header &header) {
+	uint32_t address = slot * slotSize();
+	if(!storage->read(address, (uint8_t*)&header, sizeof(Header))) return false;
+	if(header.magic != SNAPSHOT_MAGIC || header.universes > entryMax) return false;
+	uint16_t crc = crc16(0xFFFF, (const uint8_t*)&header.generation, sizeof(header.generation) + sizeof(header.universes));
+	uint8_t chunk[SNAPSHOT_CHUNK];
+	uint32_t size = (uint32_t)header.universes * SNAPSHOT_RECORD;
+	address += sizeof(Header);
+	while(size > 0) {
+		uint16_t count = size < SNAPSHOT_CHUNK ? size : SNAPSHOT_CHUNK;
+		if(!storage->read(address, chunk, count)) return false;
+		crc = crc16(crc, chunk, count);
+		address += count;
+		size -= count;
+		}
+	return crc == header.crc;
+	}
+
+uint16_t Snapshot::checksum() {
+	uint16_t crc = 0xFFFF;
+	for(uint16_t i = 0; i < entryCount; i++) {
+		crc = crc16(crc, entries[i].receiver->dmx(), DMX_SLOTS_MAX);
+		}
+	return crc;
+	}
+
+uint32_t Snapshot::slotSize() {
+	return sizeof(Header) + (uint32_t)entryMax * SNAPSHOT_RECORD;
+	}
+
+// CRC-16/CCITT
+uint16_t Snapshot::crc16(uint16_t crc, const uint8_t *data, uint16_t size) {
+	for(uint16_t i = 0; i < size; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for(uint8_t bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+			}
+		}
+	return crc;
+	}
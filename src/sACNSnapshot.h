@@ -0,0 +1,137 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_SNAPSHOT_H
+#define SACN_SNAPSHOT_H
+
+#include "Arduino.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+#include "sACNStorage.h"
+
+/**
+ * @brief Snapshots of the received universes in persistent storage
+ * 
+ * The DMX data of the receivers is written to the storage when it has
+ * changed and the snapshot interval has elapsed. Every snapshot goes to the
+ * next slot of the storage with a higher generation and a CRC, so the writes
+ * are spread over the slots and a snapshot interrupted by a power loss
+ * leaves the previous one intact, if the storage writes the slots
+ * independently (not the emulated EEPROM of ESP and RP2040, see
+ * EEPROMStorage). At boot the newest valid snapshot is restored into the
+ * receivers before the network is up.
+ */
+class Snapshot {
+	public:
+	/**
+	 * @brief Construct a new Snapshot object
+	 * 
+	 * @param storage persistent storage
+	 * @param universes maximum number of universes
+	 * @param slots number of slots, less if the storage is too small
+	 */
+	Snapshot(Storage &storage, uint16_t universes = 1, uint8_t slots = SACN_SNAPSHOT_SLOTS);
+
+	/**
+	 * @brief Destroy the Snapshot object
+	 * 
+	 */
+	~Snapshot();
+
+	/**
+	 * @brief Add the receiver of a universe
+	 * 
+	 * @param receiver receiver
+	 * @param universe DMX universe of the receiver
+	 * @return true if the universe is added
+	 * @return false if there is no space left
+	 */
+	bool add(Receiver &receiver, uint16_t universe);
+
+	/**
+	 * @brief Restore the newest valid snapshot into the receivers, call in setup() before the network begins
+	 * 
+	 * @return uint16_t number of restored universes
+	 */
+	uint16_t restore();
+
+	/**
+	 * @brief Write a snapshot if the data has changed and the interval has elapsed, must inside of loop()
+	 * 
+	 * @return true if a snapshot is written
+	 * @return false if not
+	 */
+	bool update();
+
+	/**
+	 * @brief Write a snapshot now if the data has changed
+	 * 
+	 * @return true if a snapshot is written
+	 * @return false if the data is unchanged or on error
+	 */
+	bool save();
+
+	/**
+	 * @brief Set the snapshot interval
+	 * 
+	 * @param interval minimum time between two snapshots in ms
+	 */
+	void interval(uint32_t interval);
+
+	/**
+	 * @brief Get the number of usable slots
+	 * 
+	 * @return uint8_t slots, 0 if the storage is too small
+	 */
+	uint8_t slots();
+
+	/**
+	 * @brief Get the number of written snapshots
+	 * 
+	 * @return uint32_t snapshots
+	 */
+	uint32_t writes();
+
+	private:
+	struct Header {
+		uint32_t magic;
+		uint32_t generation;
+		uint16_t universes;
+		uint16_t crc;
+		};
+	struct Entry {
+		Receiver *receiver;
+		uint16_t universe;
+		uint32_t changes;
+		};
+	static uint16_t crc16(uint16_t crc, const uint8_t *data, uint16_t size);
+	uint16_t checksum();
+	int8_t newest(Header &header);
+	bool valid(uint8_t slot, Header &header);
+	uint32_t slotSize();
+	Storage *storage;
+	Entry *entries;
+	uint16_t entryCount;
+	uint16_t entryMax;
+	uint8_t slotCount;
+	uint8_t slotNext;
+	uint32_t generation;
+	bool scanned;
+	uint16_t savedCRC;
+	uint32_t snapshotInterval;
+	uint32_t timestamp;
+	uint32_t writeCount;
+	};
+
+#endif
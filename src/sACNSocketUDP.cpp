@@ -0,0 +1,188 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNSocketUDP.h"
+
+#if defined(__linux__)
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+static uint32_t address(IPAddress ip) {
+	return htonl(((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3]);
+	}
+
+SocketUDP::SocketUDP(bool reusePort) {
+	this->reusePort = reusePort;
+	sock = -1;
+	rxSize = 0;
+	rxPosition = 0;
+	txSize = 0;
+	}
+
+SocketUDP::~SocketUDP() {
+	stop();
+	}
+
+uint8_t SocketUDP::begin(uint16_t port) {
+	stop();
+	return open(port);
+	}
+
+uint8_t SocketUDP::beginMulticast(IPAddress ip, uint16_t port) {
+	stop();
+	if(!open(port)) return 0;
+	// receive only the groups which are joined by this socket
+	int multicastAll = 0;
+	setsockopt(sock, IPPROTO_IP, IP_MULTICAST_ALL, &multicastAll, sizeof(multicastAll));
+	return join(ip);
+	}
+
+void SocketUDP::stop() {
+	if(sock >= 0) close(sock);
+	sock = -1;
+	rxSize = 0;
+	rxPosition = 0;
+	}
+
+int SocketUDP::beginPacket(IPAddress ip, uint16_t port) {
+	if(sock < 0 && !open(0)) return 0;
+	txAddress = address(ip);
+	txPort = port;
+	txSize = 0;
+	return 1;
+	}
+
+int SocketUDP::beginPacket(const char *host, uint16_t port) {
+	struct in_addr addr;
+	if(inet_aton(host, &addr) == 0) return 0;
+	if(sock < 0 && !open(0)) return 0;
+	txAddress = addr.s_addr;
+	txPort = port;
+	txSize = 0;
+	return 1;
+	}
+
+int SocketUDP::endPacket() {
+	struct sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = txAddress;
+	addr.sin_port = htons(txPort);
+	ssize_t sent = sendto(sock, txBuffer, txSize, 0, (struct sockaddr*)&addr, sizeof(addr));
+	txSize = 0;
+	return sent >= 0;
+	}
+
+size_t SocketUDP::write(uint8_t data) {
+	return write(&data, 1);
+	}
+
+size_t SocketUDP::write(const uint8_t *buffer, size_t size) {
+	if(size > (size_t)(SOCKET_UDP_BUFFER - txSize)) size = SOCKET_UDP_BUFFER - txSize;
+	memcpy(txBuffer + txSize, buffer, size);
+	txSize += size;
+	return size;
+	}
+
+int SocketUDP::parsePacket() {
+	rxSize = 0;
+	rxPosition = 0;
+	if(sock < 0) return 0;
+	struct sockaddr_in addr;
+	socklen_t length = sizeof(addr);
+	ssize_t size = recvfrom(sock, rxBuffer, SOCKET_UDP_BUFFER, MSG_DONTWAIT, (struct sockaddr*)&addr, &length);
+	if(size <= 0) return 0;
+	rxSize = size;
+	rxAddress = addr.sin_addr.s_addr;
+	rxPort = ntohs(addr.sin_port);
+	return rxSize;
+	}
+
+int SocketUDP::available() {
+	return rxSize - rxPosition;
+	}
+
+int SocketUDP::read() {
+	if(rxPosition >= rxSize) return -1;
+	return rxBuffer[rxPosition++];
+	}
+
+int SocketUDP::read(unsigned char *buffer, size_t len) {
+	size_t size = rxSize - rxPosition;
+	if(len < size) size = len;
+	memcpy(buffer, rxBuffer + rxPosition, size);
+	rxPosition += size;
+	return size;
+	}
+
+int SocketUDP::read(char *buffer, size_t len) {
+	return read((unsigned char*)buffer, len);
+	}
+
+int SocketUDP::peek() {
+	if(rxPosition >= rxSize) return -1;
+	return rxBuffer[rxPosition];
+	}
+
+void SocketUDP::flush() {
+	rxPosition = rxSize;
+	}
+
+IPAddress SocketUDP::remoteIP() {
+	uint32_t host = ntohl(rxAddress);
+	return IPAddress(host >> 24, host >> 16, host >> 8, host);
+	}
+
+uint16_t SocketUDP::remotePort() {
+	return rxPort;
+	}
+
+bool SocketUDP::join(IPAddress ip) {
+	struct ip_mreq mreq = {};
+	mreq.imr_multiaddr.s_addr = address(ip);
+	mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+	return setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0;
+	}
+
+bool SocketUDP::leave(IPAddress ip) {
+	struct ip_mreq mreq = {};
+	mreq.imr_multiaddr.s_addr = address(ip);
+	mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+	return setsockopt(sock, IPPROTO_IP, IP_DROP_MEMBERSHIP, &mreq, sizeof(mreq)) == 0;
+	}
+
+int SocketUDP::fd() {
+	return sock;
+	}
+
+bool SocketUDP::open(uint16_t port) {
+	sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(sock < 0) return false;
+	int enable = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+	if(reusePort) setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+	struct sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	if(bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+		stop();
+		return false;
+		}
+	return true;
+	}
+
+#endif
@@ -0,0 +1,106 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_SOCKET_UDP_H
+#define SACN_SOCKET_UDP_H
+
+#if defined(__linux__)
+
+#include "Arduino.h"
+#include "Udp.h"
+
+#define SOCKET_UDP_BUFFER 1472 // max UDP payload without fragmentation
+
+/**
+ * @brief UDP socket for Linux hosts using the BSD socket API
+ * 
+ * The socket is non blocking, the file descriptor can used with epoll.
+ */
+class SocketUDP : public UDP {
+	public:
+	/**
+	 * @brief Construct a new Socket UDP object
+	 * 
+	 * @param reusePort bind with SO_REUSEPORT, so more than one socket can use the same port
+	 */
+	SocketUDP(bool reusePort = false);
+
+	/**
+	 * @brief Destroy the Socket UDP object
+	 * 
+	 */
+	~SocketUDP();
+
+	uint8_t begin(uint16_t port);
+	uint8_t beginMulticast(IPAddress ip, uint16_t port);
+	void stop();
+	int beginPacket(IPAddress ip, uint16_t port);
+	int beginPacket(const char *host, uint16_t port);
+	int endPacket();
+	size_t write(uint8_t data);
+	size_t write(const uint8_t *buffer, size_t size);
+	using Print::write;
+	int parsePacket();
+	int available();
+	int read();
+	int read(unsigned char *buffer, size_t len);
+	int read(char *buffer, size_t len);
+	int peek();
+	void flush();
+	IPAddress remoteIP();
+	uint16_t remotePort();
+
+	/**
+	 * @brief Join an additional multicast group
+	 * 
+	 * @param ip multicast group
+	 * @return true if joined
+	 * @return false on error
+	 */
+	bool join(IPAddress ip);
+
+	/**
+	 * @brief Leave a multicast group
+	 * 
+	 * @param ip multicast group
+	 * @return true if left
+	 * @return false on error
+	 */
+	bool leave(IPAddress ip);
+
+	/**
+	 * @brief Get the file descriptor
+	 * 
+	 * @return int file descriptor, -1 if the socket is closed
+	 */
+	int fd();
+
+	private:
+	bool open(uint16_t port);
+	int sock;
+	bool reusePort;
+	uint8_t rxBuffer[SOCKET_UDP_BUFFER];
+	uint16_t rxSize;
+	uint16_t rxPosition;
+	uint8_t txBuffer[SOCKET_UDP_BUFFER];
+	uint16_t txSize;
+	uint32_t txAddress;
+	uint16_t txPort;
+	uint32_t rxAddress;
+	uint16_t rxPort;
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,200 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNSourceTable.h"
+
+static const uint8_t SELECTION_NONE = 0xFF;
+
+SourceTable::SourceTable(uint16_t universes, uint8_t sources, uint16_t cids) {
+	universeCount = universes;
+	sourceCount = sources;
+	cidMax = cids;
+	cidCount = 0;
+	hot = new Hot [universes * sources];
+	memset(hot, 0, sizeof(Hot) * universes * sources);
+	selection = new uint8_t [universes];
+	memset(selection, SELECTION_NONE, universes);
+	// hash index with a load factor of max 50 %
+	uint32_t size = 2;
+	while(size < 2UL * cids) size <<= 1;
+	indexMask = size - 1;
+	index = new uint16_t [size];
+	memset(index, 0, sizeof(uint16_t) * size);
+	cidTable = new uint8_t [cids * CID_SIZE];
+	nameTable = new char [cids * SOURCE_NAME_SIZE];
+	refs = new uint16_t [cids];
+	memset(refs, 0, sizeof(uint16_t) * cids);
+	}
+
+SourceTable::~SourceTable() {
+	delete[] hot;
+	delete[] selection;
+	delete[] index;
+	delete[] cidTable;
+	delete[] nameTable;
+	delete[] refs;
+	}
+
+int8_t SourceTable::accept(uint16_t universe, const uint8_t *packet, uint32_t now) {
+	if(universe >= universeCount) return SOURCE_REJECT;
+	const uint8_t *cid = packet + CID_ADDR;
+	Hot *block = hot + universe * sourceCount;
+	uint8_t seqNumber = packet[SEQ_NUM_ADDR];
+	uint8_t priority = packet[PRIORITY_ADDR];
+	int16_t slot = -1;
+	int16_t free = -1;
+	bool fresh = true;
+	for(uint8_t i = 0; i < sourceCount; i++) {
+		if(block[i].cid != 0 && memcmp(block[i].tag, cid, CID_SIZE) == 0) {
+			slot = i;
+			break;
+			}
+		if(free < 0 && (block[i].cid == 0 || (now - block[i].timestamp) > E131_NETWORK_DATA_LOSS_TIMEOUT)) free = i;
+		}
+	if(slot < 0) {
+		// no space for another source of this universe
+		if(free < 0) return SOURCE_REJECT;
+		if(block[free].cid != 0) {
+			release(block[free].cid - 1);
+			block[free].cid = 0;
+			if(selection[universe] == free) selection[universe] = SELECTION_NONE;
+			}
+		// only a new source needs the hashed index
+		int16_t index = intern(cid);
+		if(index < 0) return SOURCE_REJECT;
+		refs[index]++;
+		memcpy(block[free].tag, cid, CID_SIZE);
+		block[free].cid = index + 1;
+		slot = free;
+		}
+	else if((now - block[slot].timestamp) <= E131_NETWORK_DATA_LOSS_TIMEOUT) {
+		// verify sequence number
+		int8_t diff = seqNumber - block[slot].seqNumber;
+		if(diff <= 0 && diff > -SACN_SEQ_WINDOW) return SOURCE_REJECT;
+		fresh = false;
+		}
+	block[slot].seqNumber = seqNumber;
+	block[slot].priority = priority;
+	block[slot].timestamp = now;
+	// select source, new source with higher priority, new source after timeout
+	uint8_t current = selection[universe];
+	if(current == slot) {
+		// the source is back after a timeout
+		if(fresh) rename(block[slot].cid - 1, packet);
+		return SOURCE_ACCEPT;
+		}
+	if((current == SELECTION_NONE) || (priority > block[current].priority) || ((now - block[current].timestamp) > E131_NETWORK_DATA_LOSS_TIMEOUT)) {
+		selection[universe] = slot;
+		rename(block[slot].cid - 1, packet);
+		return SOURCE_NEW;
+		}
+	return SOURCE_REJECT;
+	}
+
+void SourceTable::expire(uint32_t now) {
+	for(uint16_t u = 0; u < universeCount; u++) {
+		Hot *block = hot + u * sourceCount;
+		for(uint8_t i = 0; i < sourceCount; i++) {
+			if(block[i].cid == 0) continue;
+			if((now - block[i].timestamp) <= E131_NETWORK_DATA_LOSS_TIMEOUT) continue;
+			release(block[i].cid - 1);
+			block[i].cid = 0;
+			if(selection[u] == i) selection[u] = SELECTION_NONE;
+			}
+		}
+	}
+
+int16_t SourceTable::find(const uint8_t cid[16]) {
+	uint16_t slot = hash(cid) & indexMask;
+	while(index[slot] != 0) {
+		uint16_t i = index[slot] - 1;
+		if(memcmp(cidTable + i * CID_SIZE, cid, CID_SIZE) == 0) return i;
+		slot = (slot + 1) & indexMask;
+		}
+	return -1;
+	}
+
+int16_t SourceTable::selected(uint16_t universe) {
+	if(universe >= universeCount || selection[universe] == SELECTION_NONE) return -1;
+	return hot[universe * sourceCount + selection[universe]].cid - 1;
+	}
+
+const uint8_t* SourceTable::cid(uint16_t index) {
+	return cidTable + index * CID_SIZE;
+	}
+
+const char* SourceTable::name(uint16_t index) {
+	return nameTable + index * SOURCE_NAME_SIZE;
+	}
+
+uint16_t SourceTable::cids() {
+	return cidCount;
+	}
+
+int16_t SourceTable::intern(const uint8_t *cid) {
+	uint16_t slot = hash(cid) & indexMask;
+	while(index[slot] != 0) {
+		uint16_t i = index[slot] - 1;
+		if(memcmp(cidTable + i * CID_SIZE, cid, CID_SIZE) == 0) return i;
+		slot = (slot + 1) & indexMask;
+		}
+	if(cidCount >= cidMax) return -1;
+	uint16_t i = 0;
+	while(refs[i] != 0) i++;
+	memcpy(cidTable + i * CID_SIZE, cid, CID_SIZE);
+	nameTable[i * SOURCE_NAME_SIZE] = 0;
+	index[slot] = i + 1;
+	cidCount++;
+	return i;
+	}
+
+void SourceTable::rename(uint16_t cid, const uint8_t *packet) {
+	// a source can change its name, take the name of the packet
+	char *name = nameTable + cid * SOURCE_NAME_SIZE;
+	memcpy(name, packet + SOURCE_NAME_ADDR, SOURCE_NAME_SIZE - 1);
+	name[SOURCE_NAME_SIZE - 1] = 0;
+	}
+
+void SourceTable::release(uint16_t cid) {
+	if(refs[cid] > 0) refs[cid]--;
+	if(refs[cid] > 0) return;
+	uint16_t slot = hash(cidTable + cid * CID_SIZE) & indexMask;
+	while(index[slot] != cid + 1) {
+		if(index[slot] == 0) return;
+		slot = (slot + 1) & indexMask;
+		}
+	// backward shift deletion keeps the probe sequences without tombstones
+	uint16_t hole = slot;
+	uint16_t next = (slot + 1) & indexMask;
+	while(index[next] != 0) {
+		uint16_t home = hash(cidTable + (index[next] - 1) * CID_SIZE) & indexMask;
+		if(((next - home) & indexMask) >= ((next - hole) & indexMask)) {
+			index[hole] = index[next];
+			hole = next;
+			}
+		next = (next + 1) & indexMask;
+		}
+	index[hole] = 0;
+	cidCount--;
+	}
+
+uint32_t SourceTable::hash(const uint8_t *cid) {
+	// FNV-1a
+	uint32_t value = 2166136261UL;
+	for(uint8_t i = 0; i < CID_SIZE; i++) {
+		value ^= cid[i];
+		value *= 16777619UL;
+		}
+	return value;
+	}
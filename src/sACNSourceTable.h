@@ -0,0 +1,136 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_SOURCE_TABLE_H
+#define SACN_SOURCE_TABLE_H
+
+#include "Arduino.h"
+#include "sACNDefs.h"
+
+// results of SourceTable::accept()
+#define SOURCE_REJECT -1 // packet is out of sequence or not from the selected source
+#define SOURCE_ACCEPT  0 // packet is from the selected source
+#define SOURCE_NEW     1 // packet is from a source which is selected now
+
+/**
+ * @brief Source registry for many universes with one block of records per universe
+ * 
+ * The fields which are needed for every packet (CID, sequence number,
+ * priority, timestamp) are packed in a 24 byte record per source, a packet
+ * of a known source reads only the 96 byte block of its universe with the
+ * default of 4 sources (two or three cache lines) and the selection byte of
+ * the universe. The cold data is kept in separate arrays, the CIDs are
+ * interned in a hashed index when a source appears and the source name is
+ * refreshed when a source is selected.
+ */
+class SourceTable {
+	public:
+	/**
+	 * @brief Construct a new Source Table object
+	 * 
+	 * @param universes number of universes, the universe index is 0...universes - 1
+	 * @param sources tracked sources per universe
+	 * @param cids maximum number of different CIDs
+	 */
+	SourceTable(uint16_t universes, uint8_t sources = SACN_SOURCE_TABLE_SOURCES, uint16_t cids = SACN_SOURCE_TABLE_CIDS);
+
+	/**
+	 * @brief Destroy the Source Table object
+	 * 
+	 */
+	~SourceTable();
+
+	/**
+	 * @brief Validate a packet against the sources of a universe
+	 * 
+	 * @param universe universe index
+	 * @param packet verified sACN packet
+	 * @param now timestamp in ms
+	 * @return int8_t SOURCE_REJECT, SOURCE_ACCEPT or SOURCE_NEW
+	 */
+	int8_t accept(uint16_t universe, const uint8_t *packet, uint32_t now);
+
+	/**
+	 * @brief Remove all sources without data for the network data loss timeout,
+	 * the receivers never call this, it must be called by the sketch from time to time
+	 * 
+	 * @param now timestamp in ms
+	 */
+	void expire(uint32_t now);
+
+	/**
+	 * @brief Lookup of a CID
+	 * 
+	 * @param cid CID of the source
+	 * @return int16_t CID index, -1 if the CID is unknown
+	 */
+	int16_t find(const uint8_t cid[16]);
+
+	/**
+	 * @brief Get the CID index of the selected source of a universe
+	 * 
+	 * @param universe universe index
+	 * @return int16_t CID index, -1 if there is no source
+	 */
+	int16_t selected(uint16_t universe);
+
+	/**
+	 * @brief Get a CID
+	 * 
+	 * @param index CID index
+	 * @return const uint8_t* CID
+	 */
+	const uint8_t* cid(uint16_t index);
+
+	/**
+	 * @brief Get a source name
+	 * 
+	 * @param index CID index
+	 * @return const char* source name
+	 */
+	const char* name(uint16_t index);
+
+	/**
+	 * @brief Get the number of interned CIDs
+	 * 
+	 * @return uint16_t CIDs in use
+	 */
+	uint16_t cids();
+
+	private:
+	struct Hot {
+		uint8_t tag[CID_SIZE]; // copy of the CID, avoids the lookup for known sources
+		uint32_t timestamp;
+		uint16_t cid; // CID index + 1, 0 for a free entry
+		uint8_t seqNumber;
+		uint8_t priority;
+		};
+	int16_t intern(const uint8_t *cid);
+	void rename(uint16_t cid, const uint8_t *packet);
+	void release(uint16_t index);
+	uint32_t hash(const uint8_t *cid);
+	Hot *hot;
+	uint8_t *selection;
+	uint16_t universeCount;
+	uint8_t sourceCount;
+	uint16_t *index;
+	uint16_t indexMask;
+	uint8_t *cidTable;
+	char *nameTable;
+	uint16_t *refs;
+	uint16_t cidMax;
+	uint16_t cidCount;
+	};
+
+#endif
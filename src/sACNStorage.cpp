@@ -0,0 +1,56 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNStorage.h"
+
+#if defined(__linux__)
+
+#include <unistd.h>
+
+FileStorage::FileStorage(const char *path, uint32_t size) {
+	fileSize = size;
+	file = fopen(path, "r+b");
+	if(file == NULL) file = fopen(path, "w+b");
+	}
+
+FileStorage::~FileStorage() {
+	if(file != NULL) fclose(file);
+	}
+
+bool FileStorage::read(uint32_t address, uint8_t *data, uint16_t size) {
+	if(file == NULL || address + size > fileSize) return false;
+	if(fseek(file, address, SEEK_SET) != 0) return false;
+	size_t count = fread(data, 1, size, file);
+	// a new file is shorter than the storage
+	if(count < size) memset(data + count, 0xFF, size - count);
+	return true;
+	}
+
+bool FileStorage::write(uint32_t address, const uint8_t *data, uint16_t size) {
+	if(file == NULL || address + size > fileSize) return false;
+	if(fseek(file, address, SEEK_SET) != 0) return false;
+	return fwrite(data, 1, size, file) == size;
+	}
+
+bool FileStorage::commit() {
+	if(file == NULL) return false;
+	if(fflush(file) != 0) return false;
+	return fsync(fileno(file)) == 0;
+	}
+
+uint32_t FileStorage::size() {
+	return fileSize;
+	}
+
+#endif
@@ -0,0 +1,102 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_STORAGE_H
+#define SACN_STORAGE_H
+
+#include "Arduino.h"
+
+/**
+ * @brief Persistent storage for snapshots, e.g. EEPROM, flash or a file
+ * 
+ */
+class Storage {
+	public:
+	virtual ~Storage() {}
+
+	/**
+	 * @brief Read data
+	 * 
+	 * @param address start address
+	 * @param data buffer
+	 * @param size number of bytes
+	 * @return true if read
+	 * @return false on error
+	 */
+	virtual bool read(uint32_t address, uint8_t *data, uint16_t size) = 0;
+
+	/**
+	 * @brief Write data, may be buffered until commit()
+	 * 
+	 * @param address start address
+	 * @param data buffer
+	 * @param size number of bytes
+	 * @return true if written
+	 * @return false on error
+	 */
+	virtual bool write(uint32_t address, const uint8_t *data, uint16_t size) = 0;
+
+	/**
+	 * @brief Make the written data persistent
+	 * 
+	 * @return true if committed
+	 * @return false on error
+	 */
+	virtual bool commit() {return true;}
+
+	/**
+	 * @brief Get the size of the storage
+	 * 
+	 * @return uint32_t size in bytes
+	 */
+	virtual uint32_t size() = 0;
+	};
+
+#if defined(__linux__)
+
+#include <stdio.h>
+
+/**
+ * @brief Storage in a file for Linux hosts
+ * 
+ */
+class FileStorage : public Storage {
+	public:
+	/**
+	 * @brief Construct a new File Storage object, the file is created if it doesn't exist
+	 * 
+	 * @param path file name
+	 * @param size size of the storage in bytes
+	 */
+	FileStorage(const char *path, uint32_t size);
+
+	/**
+	 * @brief Destroy the File Storage object
+	 * 
+	 */
+	~FileStorage();
+
+	bool read(uint32_t address, uint8_t *data, uint16_t size);
+	bool write(uint32_t address, const uint8_t *data, uint16_t size);
+	bool commit();
+	uint32_t size();
+
+	private:
+	FILE *file;
+	uint32_t fileSize;
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,189 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNSubscription.h"
+
+static const uint16_t ENTRY_NONE = 0xFFFF;
+
+Subscription::Subscription(UDP *sockets[], uint8_t count, uint16_t universes) {
+	this->sockets = sockets;
+	socketCount = count;
+	multicastCount = count;
+	entryMax = universes;
+	entryCount = 0;
+	cursor = 0;
+	idleTime = SACN_SUBSCRIPTION_IDLE;
+	unicastFallback = false;
+	entries = new Entry [entryMax];
+	socketEntry = new uint16_t [socketCount];
+	for(uint8_t i = 0; i < socketCount; i++) socketEntry[i] = ENTRY_NONE;
+	sacnPacket = new uint8_t [SACN_BUFFER_MAX];
+	}
+
+Subscription::~Subscription() {
+	delete[] entries;
+	delete[] socketEntry;
+	delete[] sacnPacket;
+	}
+
+bool Subscription::add(Receiver &receiver, uint16_t universe) {
+	if(entryCount >= entryMax) return false;
+	if(find(universe) != NULL) return false;
+	// keep the entries sorted by universe for the lookup
+	uint16_t index = entryCount;
+	while(index > 0 && entries[index - 1].universe > universe) {
+		entries[index] = entries[index - 1];
+		index--;
+		}
+	entries[index].universe = universe;
+	entries[index].receiver = &receiver;
+	entries[index].timestamp = 0;
+	entries[index].socket = -1;
+	entries[index].live = false;
+	entryCount++;
+	for(uint8_t i = 0; i < socketCount; i++) {
+		if(socketEntry[i] != ENTRY_NONE && socketEntry[i] >= index) socketEntry[i]++;
+		}
+	receiver.begin(universe);
+	return true;
+	}
+
+uint16_t Subscription::add(Receiver receivers[], uint16_t universe, uint16_t count) {
+	uint16_t added = 0;
+	for(uint16_t i = 0; i < count; i++) {
+		if(add(receivers[i], universe + i)) added++;
+		}
+	return added;
+	}
+
+void Subscription::begin(bool unicastFallback) {
+	this->unicastFallback = unicastFallback && (entryCount > socketCount) && (socketCount > 1);
+	multicastCount = this->unicastFallback ? socketCount - 1 : socketCount;
+	if(this->unicastFallback) sockets[socketCount - 1]->begin(ACN_SDT_MULTICAST_PORT);
+	for(uint8_t i = 0; i < multicastCount && i < entryCount; i++) {
+		join(i, i);
+		}
+	cursor = multicastCount < entryCount ? multicastCount : 0;
+	manageTimestamp = deviceMillis();
+	}
+
+void Subscription::stop() {
+	for(uint8_t i = 0; i < multicastCount; i++) {
+		if(socketEntry[i] != ENTRY_NONE) leave(i);
+		}
+	if(unicastFallback) sockets[socketCount - 1]->stop();
+	unicastFallback = false;
+	}
+
+uint16_t Subscription::update() {
+	uint16_t valid = 0;
+	uint32_t now = deviceMillis();
+	for(uint8_t i = 0; i < socketCount; i++) {
+		int packetSize = sockets[i]->parsePacket();
+		if(packetSize <= 0 || packetSize > SACN_BUFFER_MAX) continue;
+		sockets[i]->read(sacnPacket, SACN_BUFFER_MAX);
+		if(packetSize < SACN_BUFFER_MIN) continue;
+		Entry *entry = find((sacnPacket[UNIVERSE_ADDR] << 8) + sacnPacket[UNIVERSE_ADDR + 1]);
+		if(entry == NULL) continue;
+		if(entry->receiver->process(sacnPacket, packetSize, now)) {
+			entry->timestamp = now;
+			entry->live = true;
+			valid++;
+			}
+		}
+	// the receivers have no socket, so update() only checks the data loss timeout
+	for(uint16_t i = 0; i < entryCount; i++) {
+		entries[i].receiver->update(now);
+		}
+	if((uint32_t)(now - manageTimestamp) >= SACN_SUBSCRIPTION_INTERVAL) {
+		manageTimestamp = now;
+		manage();
+		}
+	return valid;
+	}
+
+void Subscription::idleTimeout(uint32_t timeout) {
+	idleTime = timeout;
+	}
+
+uint8_t Subscription::joined() {
+	uint8_t count = 0;
+	for(uint8_t i = 0; i < multicastCount; i++) {
+		if(socketEntry[i] != ENTRY_NONE) count++;
+		}
+	return count;
+	}
+
+bool Subscription::joined(uint16_t universe) {
+	Entry *entry = find(universe);
+	if(entry == NULL) return false;
+	return entry->socket >= 0;
+	}
+
+bool Subscription::fallback() {
+	return unicastFallback;
+	}
+
+Subscription::Entry* Subscription::find(uint16_t universe) {
+	uint16_t low = 0;
+	uint16_t high = entryCount;
+	while(low < high) {
+		uint16_t mid = (low + high) / 2;
+		if(entries[mid].universe < universe) low = mid + 1;
+		else high = mid;
+		}
+	if(low < entryCount && entries[low].universe == universe) return &entries[low];
+	return NULL;
+	}
+
+void Subscription::join(uint8_t socket, uint16_t index) {
+	uint8_t mcastIP[4] = {239, 255, 0, 0};
+	mcastIP[2] = entries[index].universe >> 8;
+	mcastIP[3] = entries[index].universe;
+	sockets[socket]->beginMulticast(mcastIP, ACN_SDT_MULTICAST_PORT);
+	socketEntry[socket] = index;
+	entries[index].socket = socket;
+	entries[index].timestamp = deviceMillis(); // start of the probe window
+	entries[index].live = false;
+	}
+
+void Subscription::leave(uint8_t socket) {
+	sockets[socket]->stop();
+	entries[socketEntry[socket]].socket = -1;
+	socketEntry[socket] = ENTRY_NONE;
+	}
+
+void Subscription::manage() {
+	// all universes have an own socket, nothing to rotate
+	if(entryCount <= multicastCount) return;
+	uint32_t now = deviceMillis();
+	for(uint8_t i = 0; i < multicastCount; i++) {
+		uint16_t index = socketEntry[i];
+		// a probed group without any data is left earlier than an idle live group
+		if(index != ENTRY_NONE && (now - entries[index].timestamp) < (entries[index].live ? idleTime : SACN_SUBSCRIPTION_PROBE)) continue;
+		// search the next waiting universe, universes with live unicast data don't need a group
+		uint16_t candidate = ENTRY_NONE;
+		for(uint16_t n = 0; n < entryCount; n++) {
+			uint16_t next = cursor;
+			cursor = (cursor + 1) % entryCount;
+			if(entries[next].socket >= 0) continue;
+			if(entries[next].live && (now - entries[next].timestamp) < idleTime) continue;
+			candidate = next;
+			break;
+			}
+		if(candidate == ENTRY_NONE) break;
+		if(index != ENTRY_NONE) leave(i);
+		join(i, candidate);
+		}
+	}
@@ -0,0 +1,146 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_SUBSCRIPTION_H
+#define SACN_SUBSCRIPTION_H
+
+#include "Arduino.h"
+#include "Udp.h"
+#include "sACN.h"
+#include "sACNDefs.h"
+
+/**
+ * @brief Multicast subscription manager for a range or set of universes
+ * 
+ * The Ethernet chips only have a few sockets, so the manager shares a pool
+ * of sockets between many receivers. Universes with live traffic stay joined,
+ * idle groups are left after a timeout and the free socket probes the next
+ * universe which is waiting. If there are more universes than sockets,
+ * the last socket of the pool listens for unicast streams of all universes.
+ */
+class Subscription {
+	public:
+	/**
+	 * @brief Construct a new Subscription object
+	 * 
+	 * @param sockets pool of UDP sockets
+	 * @param count number of sockets in the pool
+	 * @param universes maximum number of universes to manage
+	 */
+	Subscription(UDP *sockets[], uint8_t count, uint16_t universes = SACN_SUBSCRIPTION_MAX);
+
+	/**
+	 * @brief Destroy the Subscription object
+	 * 
+	 */
+	~Subscription();
+
+	/**
+	 * @brief Add a receiver for a universe, the receiver must created without a socket
+	 * 
+	 * @param receiver receiver for the universe
+	 * @param universe DMX universe to receive
+	 * @return true if the universe is added
+	 * @return false if there is no space left or the universe is already managed
+	 */
+	bool add(Receiver &receiver, uint16_t universe);
+
+	/**
+	 * @brief Add an array of receivers for a range of universes
+	 * 
+	 * @param receivers array of receivers
+	 * @param universe first DMX universe of the range
+	 * @param count number of universes
+	 * @return uint16_t number of added universes
+	 */
+	uint16_t add(Receiver receivers[], uint16_t universe, uint16_t count);
+
+	/**
+	 * @brief Begin the socket connections, call after adding the universes
+	 * 
+	 * @param unicastFallback use the last socket as unicast listener if there are more universes than sockets
+	 */
+	void begin(bool unicastFallback = true);
+
+	/**
+	 * @brief Stop all socket connections
+	 * 
+	 */
+	void stop();
+
+	/**
+	 * @brief Receive, dispatch and manage the joins, must inside of loop()
+	 * 
+	 * @return uint16_t number of valid packets
+	 */
+	uint16_t update();
+
+	/**
+	 * @brief Set the time after an idle group is left
+	 * 
+	 * @param timeout idle time in ms
+	 */
+	void idleTimeout(uint32_t timeout);
+
+	/**
+	 * @brief Get the number of joined multicast groups
+	 * 
+	 * @return uint8_t joined groups
+	 */
+	uint8_t joined();
+
+	/**
+	 * @brief Get the state of a universe
+	 * 
+	 * @param universe DMX universe
+	 * @return true if the multicast group is joined
+	 * @return false if not joined
+	 */
+	bool joined(uint16_t universe);
+
+	/**
+	 * @brief Get the state of the unicast fallback
+	 * 
+	 * @return true if the last socket listens for unicast
+	 * @return false if all sockets are used for multicast
+	 */
+	bool fallback();
+
+	private:
+	struct Entry {
+		uint16_t universe;
+		Receiver *receiver;
+		uint32_t timestamp;
+		int8_t socket;
+		bool live; // data since the join, otherwise the group is only probed
+		};
+	Entry* find(uint16_t universe);
+	void join(uint8_t socket, uint16_t index);
+	void leave(uint8_t socket);
+	void manage();
+	UDP **sockets;
+	uint8_t socketCount;
+	uint8_t multicastCount;
+	uint16_t *socketEntry;
+	Entry *entries;
+	uint16_t entryCount;
+	uint16_t entryMax;
+	uint16_t cursor;
+	uint8_t *sacnPacket;
+	uint32_t idleTime;
+	uint32_t manageTimestamp;
+	bool unicastFallback;
+	};
+
+#endif
@@ -0,0 +1,174 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNTimer.h"
+
+#define TIMER_SLOTS (1 << SACN_TIMER_BITS)
+#define TIMER_MASK  (TIMER_SLOTS - 1)
+#define TIMER_ROTATION (1UL << (SACN_TIMER_LEVELS * SACN_TIMER_BITS))
+
+Timer::Timer() {
+	next = NULL;
+	prev = NULL;
+	slot = NULL;
+	function = NULL;
+	context = NULL;
+	}
+
+void Timer::callback(tptr function, void *context) {
+	this->function = function;
+	this->context = context;
+	}
+
+bool Timer::pending() {
+	return slot != NULL;
+	}
+
+TimerWheel::TimerWheel() {
+	memset(slots, 0, sizeof(slots));
+	tick = 0;
+	timestamp = deviceMillis();
+	count = 0;
+	}
+
+void TimerWheel::start(Timer &timer, uint32_t delay) {
+	start(timer, delay, deviceMillis());
+	}
+
+void TimerWheel::start(Timer &timer, uint32_t delay, uint32_t now) {
+	if(timer.slot != NULL) unlink(&timer);
+	else count++;
+	// the ticks since the last update() are not proceeded yet
+	uint32_t lag = now - timestamp;
+	timer.expires = tick + (lag + delay) / SACN_TIMER_RESOLUTION;
+	insert(&timer);
+	}
+
+void TimerWheel::stop(Timer &timer) {
+	if(timer.slot == NULL) return;
+	unlink(&timer);
+	count--;
+	}
+
+uint16_t TimerWheel::update() {
+	uint32_t now = deviceMillis();
+	uint32_t elapsed = (now - timestamp) / SACN_TIMER_RESOLUTION;
+	if(elapsed > TIMER_ROTATION) {
+		// a jump of the clock, one rotation expires every timer, so the rest is skipped
+		elapsed = TIMER_ROTATION;
+		timestamp = now - TIMER_ROTATION * SACN_TIMER_RESOLUTION;
+		}
+	if(count == 0) {
+		// nothing scheduled, skip the idle ticks
+		tick += elapsed;
+		timestamp += elapsed * SACN_TIMER_RESOLUTION;
+		return 0;
+		}
+	uint16_t expired = 0;
+	while(elapsed--) {
+		uint8_t index = tick & TIMER_MASK;
+		for(uint8_t level = 1; level < SACN_TIMER_LEVELS && index == 0; level++) {
+			index = (tick >> (level * SACN_TIMER_BITS)) & TIMER_MASK;
+			cascade(level, index);
+			}
+		// detach the slot, callbacks can start and stop timers of the list
+		Timer *list = slots[0][tick & TIMER_MASK];
+		slots[0][tick & TIMER_MASK] = NULL;
+		for(Timer *timer = list; timer != NULL; timer = timer->next) timer->slot = &list;
+		uint32_t current = tick;
+		tick++;
+		timestamp += SACN_TIMER_RESOLUTION;
+		while(list != NULL) {
+			Timer *timer = list;
+			unlink(timer);
+			if((int32_t)(timer->expires - current) > 0) {
+				// clamped to the range of the wheel
+				insert(timer);
+				continue;
+				}
+			count--;
+			expired++;
+			if(timer->function != NULL) timer->function(timer->context);
+			}
+		if(count == 0) {
+			tick += elapsed;
+			timestamp += elapsed * SACN_TIMER_RESOLUTION;
+			break;
+			}
+		}
+	return expired;
+	}
+
+int32_t TimerWheel::next() {
+	if(count == 0) return -1;
+	uint32_t now = deviceMillis();
+	// earliest tick which proceeds or cascades a filled slot, over all levels
+	uint32_t ticks = UINT32_MAX;
+	for(uint8_t level = 0; level < SACN_TIMER_LEVELS; level++) {
+		uint8_t shift = level * SACN_TIMER_BITS;
+		for(uint32_t i = (level == 0 ? 0 : 1); i <= TIMER_SLOTS; i++) {
+			uint32_t position = (tick >> shift) + i;
+			if(slots[level][position & TIMER_MASK] == NULL) continue;
+			uint32_t distance = (position << shift) - tick;
+			if(distance < ticks) ticks = distance;
+			break;
+			}
+		}
+	int32_t delay = (int32_t)((ticks + 1) * SACN_TIMER_RESOLUTION) - (int32_t)(now - timestamp);
+	return delay > 0 ? delay : 0;
+	}
+
+uint16_t TimerWheel::timers() {
+	return count;
+	}
+
+void TimerWheel::insert(Timer *timer) {
+	uint32_t delta = timer->expires - tick;
+	uint32_t expires = timer->expires;
+	uint8_t level = 0;
+	if((int32_t)delta < 0) {
+		expires = tick;
+		}
+	else {
+		while(level < SACN_TIMER_LEVELS - 1 && delta >= (1UL << ((level + 1) * SACN_TIMER_BITS))) level++;
+		if(delta >= (1UL << (SACN_TIMER_LEVELS * SACN_TIMER_BITS))) {
+			expires = tick + (1UL << (SACN_TIMER_LEVELS * SACN_TIMER_BITS)) - 1;
+			}
+		}
+	Timer **head = &slots[level][(expires >> (level * SACN_TIMER_BITS)) & TIMER_MASK];
+	timer->slot = head;
+	timer->prev = NULL;
+	timer->next = *head;
+	if(*head != NULL) (*head)->prev = timer;
+	*head = timer;
+	}
+
+void TimerWheel::unlink(Timer *timer) {
+	if(timer->prev != NULL) timer->prev->next = timer->next;
+	else *timer->slot = timer->next;
+	if(timer->next != NULL) timer->next->prev = timer->prev;
+	timer->next = NULL;
+	timer->prev = NULL;
+	timer->slot = NULL;
+	}
+
+void TimerWheel::cascade(uint8_t level, uint8_t index) {
+	Timer *list = slots[level][index];
+	slots[level][index] = NULL;
+	while(list != NULL) {
+		Timer *timer = list;
+		list = list->next;
+		insert(timer);
+		}
+	}
@@ -0,0 +1,131 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_TIMER_H
+#define SACN_TIMER_H
+
+#include "Arduino.h"
+#include "sACNDefs.h"
+#include "sACNClock.h"
+
+/**
+ * @brief Timer for a TimerWheel, the timer is a node of the slot lists
+ * 
+ */
+class Timer {
+	typedef void (*tptr)(void *context);
+	public:
+	/**
+	 * @brief Construct a new Timer object
+	 * 
+	 */
+	Timer();
+
+	/**
+	 * @brief Set the function which is called when the timer expires
+	 * 
+	 * @param function function name to call
+	 * @param context pointer given to the function
+	 */
+	void callback(tptr function, void *context = NULL);
+
+	/**
+	 * @brief Get the state of the timer
+	 * 
+	 * @return true if the timer is scheduled
+	 * @return false if the timer is stopped or expired
+	 */
+	bool pending();
+
+	private:
+	friend class TimerWheel;
+	Timer *next;
+	Timer *prev;
+	Timer **slot;
+	uint32_t expires;
+	tptr function;
+	void *context;
+	};
+
+/**
+ * @brief Hierarchical timer wheel shared by receivers and sources
+ * 
+ * Starting and stopping a timer is O(1), update() only touches the slots
+ * of the elapsed ticks and the timers which expire. The time comparisons
+ * are wrap safe.
+ */
+class TimerWheel {
+	public:
+	/**
+	 * @brief Construct a new Timer Wheel object
+	 * 
+	 */
+	TimerWheel();
+
+	/**
+	 * @brief Start or restart a timer
+	 * 
+	 * @param timer timer
+	 * @param delay time in ms until the timer expires
+	 */
+	void start(Timer &timer, uint32_t delay);
+
+	/**
+	 * @brief Start or restart a timer with a timestamp which is already sampled
+	 * 
+	 * @param timer timer
+	 * @param delay time in ms until the timer expires
+	 * @param now time of the library clock in ms
+	 */
+	void start(Timer &timer, uint32_t delay, uint32_t now);
+
+	/**
+	 * @brief Stop a timer
+	 * 
+	 * @param timer timer
+	 */
+	void stop(Timer &timer);
+
+	/**
+	 * @brief Proceed the elapsed ticks and call the expired timers, must inside of loop()
+	 * 
+	 * @return uint16_t number of expired timers
+	 */
+	uint16_t update();
+
+	/**
+	 * @brief Get the time until the next tick with a timer, the time can be too short but never too long
+	 * 
+	 * @return int32_t time in ms, -1 if there is no timer
+	 */
+	int32_t next();
+
+	/**
+	 * @brief Get the number of scheduled timers
+	 * 
+	 * @return uint16_t timers
+	 */
+	uint16_t timers();
+
+	private:
+	void insert(Timer *timer);
+	void unlink(Timer *timer);
+	void cascade(uint8_t level, uint8_t index);
+	Timer *slots[SACN_TIMER_LEVELS][1 << SACN_TIMER_BITS];
+	uint32_t tick;
+	uint32_t timestamp;
+	uint16_t count;
+	};
+
+#endif
@@ -0,0 +1,448 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "sACNVirtual.h"
+
+// fields which are set for a path
+static const uint8_t PATH_LOSS      = 0x01;
+static const uint8_t PATH_DUPLICATE = 0x02;
+static const uint8_t PATH_REORDER   = 0x04;
+static const uint8_t PATH_DELAY     = 0x08;
+
+static uint32_t address(IPAddress ip) {
+	return ((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+	}
+
+static bool multicast(uint32_t address) {
+	return (address >> 28) == 0x0E;
+	}
+
+VirtualNetwork *VirtualNetwork::clockNetwork = NULL;
+
+VirtualNetwork::VirtualNetwork(uint16_t packets, uint32_t seed) {
+	this->seed = seed ? seed : 1;
+	pool = new Packet [packets];
+	freeList = NULL;
+	for(uint16_t i = 0; i < packets; i++) {
+		pool[i].next = freeList;
+		freeList = &pool[i];
+		}
+	sockets = NULL;
+	virtualTime = 0;
+	defaults = {};
+	defaults.reorderTime = 30;
+	paths = NULL;
+	pathCount = 0;
+	sentCount = 0;
+	deliveredCount = 0;
+	lostCount = 0;
+	duplicatedCount = 0;
+	reorderedCount = 0;
+	overflowCount = 0;
+	}
+
+VirtualNetwork::~VirtualNetwork() {
+	while(sockets != NULL) detach(sockets);
+	delete[] pool;
+	delete[] paths;
+	if(clockNetwork == this) {
+		clockNetwork = NULL;
+		deviceClock(NULL);
+		}
+	}
+
+void VirtualNetwork::loss(uint16_t permille) {
+	defaults.lossRate = permille;
+	}
+
+void VirtualNetwork::duplicate(uint16_t permille) {
+	defaults.duplicateRate = permille;
+	}
+
+void VirtualNetwork::reorder(uint16_t permille, uint32_t time) {
+	defaults.reorderRate = permille;
+	defaults.reorderTime = time;
+	}
+
+void VirtualNetwork::delay(uint32_t latency, uint32_t jitter) {
+	defaults.latency = latency;
+	defaults.jitter = jitter;
+	}
+
+bool VirtualNetwork::loss(IPAddress from, IPAddress to, uint16_t permille) {
+	Path *entry = path(from, to);
+	if(entry == NULL) return false;
+	entry->lossRate = permille;
+	entry->set |= PATH_LOSS;
+	return true;
+	}
+
+bool VirtualNetwork::duplicate(IPAddress from, IPAddress to, uint16_t permille) {
+	Path *entry = path(from, to);
+	if(entry == NULL) return false;
+	entry->duplicateRate = permille;
+	entry->set |= PATH_DUPLICATE;
+	return true;
+	}
+
+bool VirtualNetwork::reorder(IPAddress from, IPAddress to, uint16_t permille, uint32_t time) {
+	Path *entry = path(from, to);
+	if(entry == NULL) return false;
+	entry->reorderRate = permille;
+	entry->reorderTime = time;
+	entry->set |= PATH_REORDER;
+	return true;
+	}
+
+bool VirtualNetwork::delay(IPAddress from, IPAddress to, uint32_t latency, uint32_t jitter) {
+	Path *entry = path(from, to);
+	if(entry == NULL) return false;
+	entry->latency = latency;
+	entry->jitter = jitter;
+	entry->set |= PATH_DELAY;
+	return true;
+	}
+
+uint32_t VirtualNetwork::now() {
+	return virtualTime;
+	}
+
+void VirtualNetwork::now(uint32_t now) {
+	virtualTime = now;
+	}
+
+void VirtualNetwork::advance(uint32_t time) {
+	virtualTime += time;
+	}
+
+void VirtualNetwork::clock() {
+	clockNetwork = this;
+	deviceClock(clockTime);
+	}
+
+unsigned long VirtualNetwork::clockTime() {
+	return clockNetwork->virtualTime;
+	}
+
+uint32_t VirtualNetwork::sent() {
+	return sentCount;
+	}
+
+uint32_t VirtualNetwork::delivered() {
+	return deliveredCount;
+	}
+
+uint32_t VirtualNetwork::lost() {
+	return lostCount;
+	}
+
+uint32_t VirtualNetwork::duplicated() {
+	return duplicatedCount;
+	}
+
+uint32_t VirtualNetwork::reordered() {
+	return reorderedCount;
+	}
+
+uint32_t VirtualNetwork::overflows() {
+	return overflowCount;
+	}
+
+void VirtualNetwork::attach(VirtualUDP *socket) {
+	socket->next = sockets;
+	sockets = socket;
+	}
+
+void VirtualNetwork::detach(VirtualUDP *socket) {
+	for(VirtualUDP **link = &sockets; *link != NULL; link = &(*link)->next) {
+		if(*link == socket) {
+			*link = socket->next;
+			break;
+			}
+		}
+	socket->network = NULL;
+	}
+
+void VirtualNetwork::send(VirtualUDP *sender, uint32_t address, uint16_t port, const uint8_t *data, uint16_t size) {
+	sentCount++;
+	for(VirtualUDP *socket = sockets; socket != NULL; socket = socket->next) {
+		// no loopback to the sending socket
+		if(socket == sender || !socket->accepts(address, port)) continue;
+		// every path has its own loss, duplication and delay
+		Path link = route(sender->address, socket->address);
+		if(chance(link.lossRate)) {
+			lostCount++;
+			continue;
+			}
+		uint32_t time = link.latency + (link.jitter ? random() % (link.jitter + 1) : 0);
+		if(chance(link.reorderRate)) {
+			time += link.reorderTime;
+			reorderedCount++;
+			}
+		enqueue(socket, sender, data, size, time);
+		if(chance(link.duplicateRate)) {
+			duplicatedCount++;
+			enqueue(socket, sender, data, size, time + (link.jitter ? random() % (link.jitter + 1) : 0));
+			}
+		}
+	}
+
+void VirtualNetwork::enqueue(VirtualUDP *socket, VirtualUDP *sender, const uint8_t *data, uint16_t size, uint32_t delay) {
+	if(freeList == NULL || socket->queueCount >= SACN_VIRTUAL_QUEUE) {
+		overflowCount++;
+		return;
+		}
+	Packet *packet = freeList;
+	freeList = packet->next;
+	packet->deliver = virtualTime + delay;
+	packet->sourceAddress = sender->address;
+	packet->sourcePort = sender->port;
+	packet->size = size;
+	memcpy(packet->data, data, size);
+	// the queue is sorted by delivery time, packets with the same time keep their order
+	Packet **link = &socket->queue;
+	while(*link != NULL && (int32_t)((*link)->deliver - packet->deliver) <= 0) link = &(*link)->next;
+	packet->next = *link;
+	*link = packet;
+	socket->queueCount++;
+	}
+
+VirtualNetwork::Path* VirtualNetwork::path(IPAddress from, IPAddress to) {
+	uint32_t source = address(from);
+	uint32_t destination = address(to);
+	for(uint8_t i = 0; i < pathCount; i++) {
+		if(paths[i].from == source && paths[i].to == destination) return &paths[i];
+		}
+	if(paths == NULL) paths = new Path [SACN_VIRTUAL_PATHS];
+	if(pathCount >= SACN_VIRTUAL_PATHS) return NULL;
+	// a new path sets no field, they follow the network until they are set
+	Path *entry = &paths[pathCount];
+	*entry = {};
+	pathCount++;
+	entry->from = source;
+	entry->to = destination;
+	return entry;
+	}
+
+VirtualNetwork::Path VirtualNetwork::route(uint32_t from, uint32_t to) {
+	// every field comes from the most specific path which sets it: sender and receiver, sender, receiver, network
+	Path link = defaults;
+	uint8_t score[4] = {0, 0, 0, 0};
+	for(uint8_t i = 0; i < pathCount; i++) {
+		const Path &entry = paths[i];
+		if(entry.from != 0 && entry.from != from) continue;
+		if(entry.to != 0 && entry.to != to) continue;
+		uint8_t rank = 1 + (entry.from != 0 ? 2 : 0) + (entry.to != 0 ? 1 : 0);
+		if((entry.set & PATH_LOSS) && rank > score[0]) {
+			link.lossRate = entry.lossRate;
+			score[0] = rank;
+			}
+		if((entry.set & PATH_DUPLICATE) && rank > score[1]) {
+			link.duplicateRate = entry.duplicateRate;
+			score[1] = rank;
+			}
+		if((entry.set & PATH_REORDER) && rank > score[2]) {
+			link.reorderRate = entry.reorderRate;
+			link.reorderTime = entry.reorderTime;
+			score[2] = rank;
+			}
+		if((entry.set & PATH_DELAY) && rank > score[3]) {
+			link.latency = entry.latency;
+			link.jitter = entry.jitter;
+			score[3] = rank;
+			}
+		}
+	return link;
+	}
+
+void VirtualNetwork::release(Packet *packet) {
+	packet->next = freeList;
+	freeList = packet;
+	}
+
+uint32_t VirtualNetwork::random() {
+	// xorshift32
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+	}
+
+bool VirtualNetwork::chance(uint16_t permille) {
+	if(permille == 0) return false;
+	return (random() % 1000) < permille;
+	}
+
+VirtualUDP::VirtualUDP(VirtualNetwork &network, IPAddress ip) {
+	this->network = &network;
+	address = ::address(ip);
+	port = 0;
+	bound = false;
+	groupCount = 0;
+	queue = NULL;
+	queueCount = 0;
+	current = NULL;
+	position = 0;
+	txSize = 0;
+	network.attach(this);
+	}
+
+VirtualUDP::~VirtualUDP() {
+	stop();
+	if(network != NULL) network->detach(this);
+	}
+
+uint8_t VirtualUDP::begin(uint16_t port) {
+	stop();
+	this->port = port;
+	bound = true;
+	return 1;
+	}
+
+uint8_t VirtualUDP::beginMulticast(IPAddress ip, uint16_t port) {
+	begin(port);
+	return join(ip);
+	}
+
+void VirtualUDP::stop() {
+	bound = false;
+	groupCount = 0;
+	if(network == NULL) return;
+	if(current != NULL) network->release(current);
+	current = NULL;
+	while(queue != NULL) {
+		VirtualNetwork::Packet *packet = queue;
+		queue = packet->next;
+		network->release(packet);
+		}
+	queueCount = 0;
+	}
+
+int VirtualUDP::beginPacket(IPAddress ip, uint16_t port) {
+	txAddress = ::address(ip);
+	txPort = port;
+	txSize = 0;
+	return 1;
+	}
+
+int VirtualUDP::beginPacket(const char *host, uint16_t port) {
+	uint8_t ip[4];
+	for(uint8_t i = 0; i < 4; i++) {
+		ip[i] = strtoul(host, (char**)&host, 10);
+		if(*host == '.') host++;
+		}
+	return beginPacket(IPAddress(ip), port);
+	}
+
+int VirtualUDP::endPacket() {
+	if(network == NULL) return 0;
+	network->send(this, txAddress, txPort, txBuffer, txSize);
+	txSize = 0;
+	return 1;
+	}
+
+size_t VirtualUDP::write(uint8_t data) {
+	return write(&data, 1);
+	}
+
+size_t VirtualUDP::write(const uint8_t *buffer, size_t size) {
+	if(size > (size_t)(SACN_BUFFER_MAX - txSize)) size = SACN_BUFFER_MAX - txSize;
+	memcpy(txBuffer + txSize, buffer, size);
+	txSize += size;
+	return size;
+	}
+
+int VirtualUDP::parsePacket() {
+	if(network == NULL) return 0;
+	if(current != NULL) network->release(current);
+	current = NULL;
+	position = 0;
+	if(queue == NULL || (int32_t)(queue->deliver - network->virtualTime) > 0) return 0;
+	current = queue;
+	queue = current->next;
+	queueCount--;
+	network->deliveredCount++;
+	return current->size;
+	}
+
+int VirtualUDP::available() {
+	if(current == NULL) return 0;
+	return current->size - position;
+	}
+
+int VirtualUDP::read() {
+	if(available() <= 0) return -1;
+	return current->data[position++];
+	}
+
+int VirtualUDP::read(unsigned char *buffer, size_t len) {
+	size_t size = available();
+	if(len < size) size = len;
+	if(size > 0) memcpy(buffer, current->data + position, size);
+	position += size;
+	return size;
+	}
+
+int VirtualUDP::read(char *buffer, size_t len) {
+	return read((unsigned char*)buffer, len);
+	}
+
+int VirtualUDP::peek() {
+	if(available() <= 0) return -1;
+	return current->data[position];
+	}
+
+void VirtualUDP::flush() {
+	if(current != NULL) position = current->size;
+	}
+
+IPAddress VirtualUDP::remoteIP() {
+	if(current == NULL) return IPAddress(0, 0, 0, 0);
+	return IPAddress(current->sourceAddress >> 24, current->sourceAddress >> 16, current->sourceAddress >> 8, current->sourceAddress);
+	}
+
+uint16_t VirtualUDP::remotePort() {
+	if(current == NULL) return 0;
+	return current->sourcePort;
+	}
+
+bool VirtualUDP::join(IPAddress ip) {
+	if(groupCount >= SACN_VIRTUAL_GROUPS) return false;
+	groups[groupCount++] = ::address(ip);
+	return true;
+	}
+
+bool VirtualUDP::leave(IPAddress ip) {
+	uint32_t group = ::address(ip);
+	for(uint8_t i = 0; i < groupCount; i++) {
+		if(groups[i] == group) {
+			groups[i] = groups[--groupCount];
+			return true;
+			}
+		}
+	return false;
+	}
+
+uint16_t VirtualUDP::queued() {
+	return queueCount;
+	}
+
+bool VirtualUDP::accepts(uint32_t address, uint16_t port) {
+	if(!bound || port != this->port) return false;
+	if(!multicast(address)) return address == this->address;
+	for(uint8_t i = 0; i < groupCount; i++) {
+		if(groups[i] == address) return true;
+		}
+	return false;
+	}
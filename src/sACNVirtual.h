@@ -0,0 +1,299 @@
+/* Arduino library for sending and receiving sACN lighting protocoll ANSI E1.31
+ *
+ * (c) 2022 stefan staub
+ * Released under the MIT License
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SACN_VIRTUAL_H
+#define SACN_VIRTUAL_H
+
+#include "Arduino.h"
+#include "Udp.h"
+#include "sACNDefs.h"
+#include "sACNClock.h"
+
+class VirtualUDP;
+
+/**
+ * @brief In memory network for testing receivers and sources without hardware
+ * 
+ * Any number of VirtualUDP sockets are connected by the network. Loss,
+ * duplication, reordering, delay and jitter are configurable for the whole
+ * network and for single paths from one socket to another, the delivery
+ * is driven by a virtual clock and a seeded random generator, so every run
+ * with the same settings gives the same result.
+ */
+class VirtualNetwork {
+	public:
+	/**
+	 * @brief Construct a new Virtual Network object
+	 * 
+	 * @param packets maximum number of packets in flight
+	 * @param seed start number for the random generator
+	 */
+	VirtualNetwork(uint16_t packets = SACN_VIRTUAL_PACKETS, uint32_t seed = 1);
+
+	/**
+	 * @brief Destroy the Virtual Network object
+	 * 
+	 */
+	~VirtualNetwork();
+
+	/**
+	 * @brief Set the packet loss
+	 * 
+	 * @param permille lost packets per 1000
+	 */
+	void loss(uint16_t permille);
+
+	/**
+	 * @brief Set the packet duplication
+	 * 
+	 * @param permille duplicated packets per 1000
+	 */
+	void duplicate(uint16_t permille);
+
+	/**
+	 * @brief Set the packet reordering
+	 * 
+	 * @param permille packets per 1000 which are held back
+	 * @param time time in ms a packet is held back
+	 */
+	void reorder(uint16_t permille, uint32_t time = 30);
+
+	/**
+	 * @brief Set the delay of the packets
+	 * 
+	 * @param latency fixed delay in ms
+	 * @param jitter additional random delay 0...jitter in ms
+	 */
+	void delay(uint32_t latency, uint32_t jitter = 0);
+
+	/**
+	 * @brief Set the packet loss of a path, the settings of a path override the settings of the network,
+	 * settings which are not set for a path follow the network or a less specific path
+	 * 
+	 * @param from address of the sending socket, 0.0.0.0 for all senders
+	 * @param to address of the receiving socket, 0.0.0.0 for all receivers
+	 * @param permille lost packets per 1000
+	 * @return true if set
+	 * @return false if there is no space for another path
+	 */
+	bool loss(IPAddress from, IPAddress to, uint16_t permille);
+
+	/**
+	 * @brief Set the packet duplication of a path
+	 * 
+	 * @param from address of the sending socket, 0.0.0.0 for all senders
+	 * @param to address of the receiving socket, 0.0.0.0 for all receivers
+	 * @param permille duplicated packets per 1000
+	 * @return true if set
+	 * @return false if there is no space for another path
+	 */
+	bool duplicate(IPAddress from, IPAddress to, uint16_t permille);
+
+	/**
+	 * @brief Set the packet reordering of a path
+	 * 
+	 * @param from address of the sending socket, 0.0.0.0 for all senders
+	 * @param to address of the receiving socket, 0.0.0.0 for all receivers
+	 * @param permille packets per 1000 which are held back
+	 * @param time time in ms a packet is held back
+	 * @return true if set
+	 * @return false if there is no space for another path
+	 */
+	bool reorder(IPAddress from, IPAddress to, uint16_t permille, uint32_t time = 30);
+
+	/**
+	 * @brief Set the delay of a path
+	 * 
+	 * @param from address of the sending socket, 0.0.0.0 for all senders
+	 * @param to address of the receiving socket, 0.0.0.0 for all receivers
+	 * @param latency fixed delay in ms
+	 * @param jitter additional random delay 0...jitter in ms
+	 * @return true if set
+	 * @return false if there is no space for another path
+	 */
+	bool delay(IPAddress from, IPAddress to, uint32_t latency, uint32_t jitter = 0);
+
+	/**
+	 * @brief Get the time of the virtual clock
+	 * 
+	 * @return uint32_t time in ms
+	 */
+	uint32_t now();
+
+	/**
+	 * @brief Set the time of the virtual clock
+	 * 
+	 * @param now time in ms
+	 */
+	void now(uint32_t now);
+
+	/**
+	 * @brief Advance the virtual clock
+	 * 
+	 * @param time time in ms
+	 */
+	void advance(uint32_t time);
+
+	/**
+	 * @brief Drive the clock of the library with the virtual clock,
+	 * so the timeouts of receivers and sources follow now() and advance()
+	 * 
+	 */
+	void clock();
+
+	/**
+	 * @brief Get the statistics
+	 * 
+	 * @return uint32_t number of packets
+	 */
+	uint32_t sent();
+	uint32_t delivered();
+	uint32_t lost();
+	uint32_t duplicated();
+	uint32_t reordered();
+	uint32_t overflows();
+
+	private:
+	friend class VirtualUDP;
+	struct Packet {
+		Packet *next;
+		uint32_t deliver;
+		uint32_t sourceAddress;
+		uint16_t sourcePort;
+		uint16_t size;
+		uint8_t data[SACN_BUFFER_MAX];
+		};
+	struct Path {
+		uint32_t from; // 0 for all senders
+		uint32_t to; // 0 for all receivers
+		uint16_t lossRate;
+		uint16_t duplicateRate;
+		uint16_t reorderRate;
+		uint32_t reorderTime;
+		uint32_t latency;
+		uint32_t jitter;
+		uint8_t set; // fields set for the path, the others follow the network
+		};
+	void attach(VirtualUDP *socket);
+	void detach(VirtualUDP *socket);
+	void send(VirtualUDP *sender, uint32_t address, uint16_t port, const uint8_t *data, uint16_t size);
+	void enqueue(VirtualUDP *socket, VirtualUDP *sender, const uint8_t *data, uint16_t size, uint32_t delay);
+	void release(Packet *packet);
+	Path* path(IPAddress from, IPAddress to);
+	Path route(uint32_t from, uint32_t to);
+	uint32_t random();
+	static unsigned long clockTime();
+	static VirtualNetwork *clockNetwork;
+	bool chance(uint16_t permille);
+	Packet *pool;
+	Packet *freeList;
+	VirtualUDP *sockets;
+	uint32_t seed;
+	uint32_t virtualTime;
+	Path defaults;
+	Path *paths;
+	uint8_t pathCount;
+	uint32_t sentCount;
+	uint32_t deliveredCount;
+	uint32_t lostCount;
+	uint32_t duplicatedCount;
+	uint32_t reorderedCount;
+	uint32_t overflowCount;
+	};
+
+/**
+ * @brief UDP socket of a VirtualNetwork
+ * 
+ */
+class VirtualUDP : public UDP {
+	public:
+	/**
+	 * @brief Construct a new Virtual UDP object
+	 * 
+	 * @param network virtual network
+	 * @param ip unicast address of the socket
+	 */
+	VirtualUDP(VirtualNetwork &network, IPAddress ip);
+
+	/**
+	 * @brief Destroy the Virtual UDP object
+	 * 
+	 */
+	~VirtualUDP();
+
+	uint8_t begin(uint16_t port);
+	uint8_t beginMulticast(IPAddress ip, uint16_t port);
+	void stop();
+	int beginPacket(IPAddress ip, uint16_t port);
+	int beginPacket(const char *host, uint16_t port);
+	int endPacket();
+	size_t write(uint8_t data);
+	size_t write(const uint8_t *buffer, size_t size);
+	using Print::write;
+	int parsePacket();
+	int available();
+	int read();
+	int read(unsigned char *buffer, size_t len);
+	int read(char *buffer, size_t len);
+	int peek();
+	void flush();
+	IPAddress remoteIP();
+	uint16_t remotePort();
+
+	/**
+	 * @brief Join an additional multicast group
+	 * 
+	 * @param ip multicast group
+	 * @return true if joined
+	 * @return false if there is no space left
+	 */
+	bool join(IPAddress ip);
+
+	/**
+	 * @brief Leave a multicast group
+	 * 
+	 * @param ip multicast group
+	 * @return true if left
+	 * @return false if not joined
+	 */
+	bool leave(IPAddress ip);
+
+	/**
+	 * @brief Get the number of queued packets, including packets which are not due yet
+	 * 
+	 * @return uint16_t queued packets
+	 */
+	uint16_t queued();
+
+	private:
+	friend class VirtualNetwork;
+	bool accepts(uint32_t address, uint16_t port);
+	VirtualNetwork *network;
+	VirtualUDP *next;
+	uint32_t address;
+	uint16_t port;
+	bool bound;
+	uint32_t groups[SACN_VIRTUAL_GROUPS];
+	uint8_t groupCount;
+	VirtualNetwork::Packet *queue;
+	uint16_t queueCount;
+	VirtualNetwork::Packet *current;
+	uint16_t position;
+	uint8_t txBuffer[SACN_BUFFER_MAX];
+	uint16_t txSize;
+	uint32_t txAddress;
+	uint16_t txPort;
+	};
+
+#endif